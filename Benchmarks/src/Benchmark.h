@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// Minimal benchmark harness. BENCHMARK defines a function that BenchmarkMain.cpp runs, which
+// prints its own measurements. Meant for Release builds.
+namespace Hazel::Benchmark
+{
+    using BenchmarkFunc = void (*)();
+
+    struct BenchmarkCase
+    {
+        const char* Name;
+        BenchmarkFunc Func;
+    };
+
+    std::vector<BenchmarkCase>& Registry();
+
+    struct Registrar
+    {
+        Registrar(const char* name, BenchmarkFunc func)
+        {
+            Registry().push_back({name, func});
+        }
+    };
+
+    // Best wall time of repeats calls of func, in milliseconds
+    template <typename Func>
+    double MeasureMs(unsigned repeats, Func&& func)
+    {
+        double best = 0.0;
+        for (unsigned i = 0; i < repeats; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            func();
+            const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = i == 0 ? elapsed : std::min(best, elapsed);
+        }
+        return best;
+    }
+
+    inline volatile char s_Sink = 0;
+
+    // Keeps the compiler from dropping the computation of value
+    template <typename T>
+    void Consume(const T& value)
+    {
+        s_Sink = *reinterpret_cast<const volatile char*>(&value);
+    }
+}
+
+#define BENCHMARK(name) \
+    static void name(); \
+    static ::Hazel::Benchmark::Registrar s_##name##Registrar(#name, &name); \
+    static void name()
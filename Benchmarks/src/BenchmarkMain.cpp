@@ -0,0 +1,37 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "Hazel/Core/Log.h"
+
+namespace Hazel::Benchmark
+{
+    std::vector<BenchmarkCase>& Registry()
+    {
+        static std::vector<BenchmarkCase> s_Registry;
+        return s_Registry;
+    }
+}
+
+// Runs every benchmark, or the ones whose name contains the first argument
+int main(int argc, char** argv)
+{
+    Hazel::Log::Init();
+
+#ifdef HZ_DEBUG
+    std::printf("Debug build, the timings are not representative\n");
+#endif
+
+    const char* filter = argc > 1 ? argv[1] : "";
+    for (const Hazel::Benchmark::BenchmarkCase& benchmark : Hazel::Benchmark::Registry())
+    {
+        if (std::strstr(benchmark.Name, filter))
+        {
+            std::printf("%s\n", benchmark.Name);
+            benchmark.Func();
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+#include "Hazel/ECS/Broadphase.h"
+#include "Hazel/ECS/SpatialIndex.h"
+
+using namespace Hazel;
+using namespace Hazel::Benchmark;
+
+namespace
+{
+    // Deterministic, so that every run measures the same world
+    class Random
+    {
+    public:
+        float Next()
+        {
+            m_State = m_State * 1664525u + 1013904223u;
+            return static_cast<float>(m_State >> 8) / static_cast<float>(1 << 24);
+        }
+
+    private:
+        uint32_t m_State = 3;
+    };
+
+    // A uniform grid broadphase: every box queries the grid and keeps the partners with a larger handle
+    void FindGridPairs(const SpatialHashGrid& grid, const std::vector<SpatialEntry>& boxes, std::vector<OverlapPair>& pairs)
+    {
+        pairs.clear();
+        for (const SpatialEntry& box : boxes)
+        {
+            grid.Query(box.Bounds, [&](const SpatialEntry& other)
+            {
+                if (other.Handle > box.Handle)
+                {
+                    pairs.push_back({box.Handle, other.Handle});
+                }
+            });
+        }
+        std::sort(pairs.begin(), pairs.end(), [](const OverlapPair& a, const OverlapPair& b) { return a.Key() < b.Key(); });
+    }
+
+    // count boxes of 0.5 to 1 units, about 0.3 overlaps per box, all moving a little every frame.
+    // Milliseconds per frame, updating the boxes and finding every pair.
+    void MeasureBroadphases(unsigned count)
+    {
+        Random random;
+        const float side = std::sqrt(static_cast<float>(count)) * 2.0f;
+        std::vector<SpatialEntry> boxes(count);
+        std::vector<glm::vec2> velocities(count);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const glm::vec2 center = {random.Next() * side, random.Next() * side};
+            boxes[i] = {MakeEntity(i, 0), AABB::FromCenter(center, glm::vec2(0.25f + random.Next() * 0.25f))};
+            velocities[i] = {random.Next() * 0.1f - 0.05f, random.Next() * 0.1f - 0.05f};
+        }
+
+        SweepAndPrune sweepAndPrune;
+        SpatialHashGrid grid(1.0f);
+        for (const SpatialEntry& box : boxes)
+        {
+            sweepAndPrune.Insert(box.Handle, box.Bounds);
+            grid.Insert(box.Handle, box.Bounds);
+        }
+        std::vector<OverlapPair> pairs;
+        std::vector<OverlapPair> gridPairs;
+        sweepAndPrune.FindPairs(pairs);
+
+        const unsigned frames = count >= 1000000 ? 5 : 20;
+        double sweepMs = 0.0;
+        double gridMs = 0.0;
+        for (unsigned frame = 0; frame < frames; ++frame)
+        {
+            for (unsigned i = 0; i < count; ++i)
+            {
+                boxes[i].Bounds.Min = boxes[i].Bounds.Min + velocities[i];
+                boxes[i].Bounds.Max = boxes[i].Bounds.Max + velocities[i];
+            }
+
+            sweepMs += MeasureMs(1, [&]
+            {
+                for (const SpatialEntry& box : boxes)
+                {
+                    sweepAndPrune.Update(box.Handle, box.Bounds);
+                }
+                sweepAndPrune.FindPairs(pairs);
+            });
+            gridMs += MeasureMs(1, [&]
+            {
+                for (const SpatialEntry& box : boxes)
+                {
+                    grid.Update(box.Handle, box.Bounds);
+                }
+                FindGridPairs(grid, boxes, gridPairs);
+            });
+
+            if (pairs.size() != gridPairs.size())
+            {
+                std::printf("  %7u boxes: the broadphases disagree, %zu against %zu pairs\n", count, pairs.size(), gridPairs.size());
+                return;
+            }
+        }
+
+        std::printf("  %7u boxes %7zu pairs   sweep and prune %8.2f ms   uniform grid %8.2f ms\n",
+                    count, pairs.size(), sweepMs / frames, gridMs / frames);
+    }
+}
+
+// The banded sweep and prune of BroadphaseSystem against querying a uniform grid once per box
+BENCHMARK(SweepAndPruneVersusUniformGrid)
+{
+    for (const unsigned count : {10000u, 100000u, 1000000u})
+    {
+        MeasureBroadphases(count);
+    }
+}
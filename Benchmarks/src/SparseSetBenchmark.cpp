@@ -0,0 +1,135 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+
+#include "Hazel/ECS/ComponentArray.h"
+
+using namespace Hazel;
+using namespace Hazel::Benchmark;
+
+namespace
+{
+    struct Payload
+    {
+        float Values[8];
+    };
+
+    // The pool as it was before the sparse set: two hash maps between entities and packed indices
+    class HashMapArray
+    {
+    public:
+        void InsertData(Entity entity, const Payload& component)
+        {
+            const size_t index = m_Components.size();
+            m_EntityToIndexMap[entity] = index;
+            m_IndexToEntityMap[index] = entity;
+            m_Components.push_back(component);
+        }
+
+        void RemoveData(Entity entity)
+        {
+            const size_t indexOfRemovedEntity = m_EntityToIndexMap[entity];
+            const size_t indexOfLastElement = m_Components.size() - 1;
+            m_Components[indexOfRemovedEntity] = m_Components[indexOfLastElement];
+
+            const Entity entityOfLastElement = m_IndexToEntityMap[indexOfLastElement];
+            m_EntityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
+            m_IndexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+
+            m_EntityToIndexMap.erase(entity);
+            m_IndexToEntityMap.erase(indexOfLastElement);
+            m_Components.pop_back();
+        }
+
+        const Payload& GetData(Entity entity) const
+        {
+            return m_Components[m_EntityToIndexMap.find(entity)->second];
+        }
+
+        bool Contains(Entity entity) const
+        {
+            return m_EntityToIndexMap.find(entity) != m_EntityToIndexMap.end();
+        }
+
+    private:
+        std::vector<Payload> m_Components;
+        std::unordered_map<Entity, size_t> m_EntityToIndexMap;
+        std::unordered_map<size_t, Entity> m_IndexToEntityMap;
+    };
+
+    // Inserts, looks up and removes count components in shuffled entity order, nanoseconds per operation
+    template <typename Pool>
+    void MeasurePool(const char* name, unsigned count)
+    {
+        std::vector<Entity> entities(count);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            entities[i] = MakeEntity(i, 1);
+        }
+        std::shuffle(entities.begin(), entities.end(), std::mt19937(42));
+
+        double insert = 0.0;
+        double get = 0.0;
+        double contains = 0.0;
+        double remove = 0.0;
+        for (unsigned repeat = 0; repeat < 5; ++repeat)
+        {
+            Pool pool;
+            const double insertMs = MeasureMs(1, [&]
+            {
+                for (const Entity entity : entities)
+                {
+                    pool.InsertData(entity, Payload{{static_cast<float>(entity)}});
+                }
+            });
+            const double getMs = MeasureMs(1, [&]
+            {
+                float sum = 0.0f;
+                for (const Entity entity : entities)
+                {
+                    sum += std::as_const(pool).GetData(entity).Values[0];
+                }
+                Consume(sum);
+            });
+            const double containsMs = MeasureMs(1, [&]
+            {
+                // Every other lookup with a stale handle, from an earlier generation of the slot
+                unsigned found = 0;
+                for (const Entity entity : entities)
+                {
+                    found += pool.Contains(entity & 1 ? MakeEntity(EntityIndex(entity), 0) : entity) ? 1 : 0;
+                }
+                Consume(found);
+            });
+            const double removeMs = MeasureMs(1, [&]
+            {
+                for (auto it = entities.rbegin(); it != entities.rend(); ++it)
+                {
+                    pool.RemoveData(*it);
+                }
+            });
+
+            insert = repeat == 0 ? insertMs : std::min(insert, insertMs);
+            get = repeat == 0 ? getMs : std::min(get, getMs);
+            contains = repeat == 0 ? containsMs : std::min(contains, containsMs);
+            remove = repeat == 0 ? removeMs : std::min(remove, removeMs);
+        }
+
+        const double toNs = 1e6 / count;
+        std::printf("  %-16s %7u   insert %6.1f   get %6.1f   contains %6.1f   remove %6.1f ns/op\n",
+                    name, count, insert * toNs, get * toNs, contains * toNs, remove * toNs);
+    }
+}
+
+// The paged sparse set against the hash map pool it replaced, at three world sizes
+BENCHMARK(SparseSetVersusHashMap)
+{
+    for (const unsigned count : {5000u, 50000u, 500000u})
+    {
+        MeasurePool<HashMapArray>("hash maps", count);
+        MeasurePool<ComponentArray<Payload>>("sparse set", count);
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+
+#include "glm/glm.hpp"
+
+namespace Hazel
+{
+    // Axis-aligned bounding box in the xy plane
+    struct AABB
+    {
+        glm::vec2 Min;
+        glm::vec2 Max;
+
+        static AABB FromCenter(const glm::vec2& center, const glm::vec2& halfExtents)
+        {
+            return {center - halfExtents, center + halfExtents};
+        }
+
+        glm::vec2 GetCenter() const
+        {
+            return (Min + Max) * 0.5f;
+        }
+
+        glm::vec2 GetHalfExtents() const
+        {
+            return (Max - Min) * 0.5f;
+        }
+
+        bool Intersects(const AABB& other) const
+        {
+            return Min.x <= other.Max.x && other.Min.x <= Max.x && Min.y <= other.Max.y && other.Min.y <= Max.y;
+        }
+
+        bool Contains(const glm::vec2& point) const
+        {
+            return point.x >= Min.x && point.x <= Max.x && point.y >= Min.y && point.y <= Max.y;
+        }
+
+        // Squared distance from point to the closest point of the box, 0 inside
+        float DistanceSquared(const glm::vec2& point) const
+        {
+            const glm::vec2 delta = glm::max(glm::max(Min - point, point - Max), glm::vec2(0.0f));
+            return glm::dot(delta, delta);
+        }
+
+        AABB Expanded(float margin) const
+        {
+            return {Min - glm::vec2(margin), Max + glm::vec2(margin)};
+        }
+    };
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include "Hazel/Core/Core.h"
+
+namespace Hazel
+{
+    // Read-only file mapped into memory. Writes to the mapped bytes are private to the process and
+    // never reach the file, the operating system copies a memory page on its first write.
+    class MappedFile
+    {
+    public:
+        virtual ~MappedFile() = default;
+
+        virtual char* GetData() = 0;
+        virtual size_t GetSize() const = 0;
+
+        // Returns nullptr if the file cannot be opened or mapped
+        static Ref<MappedFile> Open(const std::string& path);
+    };
+}
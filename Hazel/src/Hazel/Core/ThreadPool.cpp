@@ -0,0 +1,124 @@
+#include "hzpch.h"
+#include "ThreadPool.h"
+
+namespace Hazel
+{
+    // Set on pool workers and on a dispatching thread while it runs jobs, nested dispatches run inline
+    static thread_local bool t_InsideJob = false;
+
+    ThreadPool::ThreadPool(unsigned workerCount)
+    {
+        m_Workers.reserve(workerCount);
+        for (unsigned i = 0; i < workerCount; ++i)
+        {
+            m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_WakeCondition.notify_all();
+        for (auto& worker : m_Workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::ParallelFor(unsigned count, const std::function<void(unsigned)>& func,
+                                 const std::function<void()>& callerFunc)
+    {
+        // A single index is only worth handing to a worker when the caller has work of its own
+        std::unique_lock<std::mutex> dispatchLock(m_DispatchMutex, std::defer_lock);
+        if (count == 0 || (count == 1 && !callerFunc) || m_Workers.empty() || t_InsideJob || !dispatchLock.try_lock())
+        {
+            if (callerFunc)
+            {
+                callerFunc();
+            }
+            for (unsigned i = 0; i < count; ++i)
+            {
+                func(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Job = &func;
+            m_JobCount = count;
+            m_NextIndex = 0;
+            m_FinishedCount = 0;
+            ++m_Generation;
+        }
+        m_WakeCondition.notify_all();
+
+        t_InsideJob = true;
+        if (callerFunc)
+        {
+            callerFunc();
+        }
+        RunJobs(func, count);
+        t_InsideJob = false;
+
+        // Wait for the last indices and for every worker to leave the batch, then close it so
+        // that late wakers cannot join a batch whose job no longer exists
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_DoneCondition.wait(lock, [this, count] { return m_FinishedCount == count && m_BusyWorkers == 0; });
+        m_Job = nullptr;
+    }
+
+    ThreadPool& ThreadPool::Get()
+    {
+        static ThreadPool s_Instance(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return s_Instance;
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        t_InsideJob = true;
+        unsigned seenGeneration = 0;
+        while (true)
+        {
+            const std::function<void(unsigned)>* job;
+            unsigned count;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WakeCondition.wait(lock, [this, seenGeneration] { return m_Stopping || m_Generation != seenGeneration; });
+                if (m_Stopping)
+                {
+                    return;
+                }
+                seenGeneration = m_Generation;
+                if (!m_Job)
+                {
+                    // Woke up after the batch was already closed
+                    continue;
+                }
+                job = m_Job;
+                count = m_JobCount;
+                ++m_BusyWorkers;
+            }
+
+            RunJobs(*job, count);
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                --m_BusyWorkers;
+            }
+            m_DoneCondition.notify_all();
+        }
+    }
+
+    void ThreadPool::RunJobs(const std::function<void(unsigned)>& func, unsigned count)
+    {
+        for (unsigned index = m_NextIndex++; index < count; index = m_NextIndex++)
+        {
+            func(index);
+            ++m_FinishedCount;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Hazel
+{
+    // Fixed set of worker threads that execute index ranges. The calling thread takes part in
+    // the work, so a pool with zero workers simply runs everything inline.
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(unsigned workerCount);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Runs func(index) for every index in [0, count) and returns once all of them finished.
+        // Calls made from inside a job, or while another thread is dispatching, run inline.
+        // callerFunc runs on the calling thread while the workers start on the indices, then the
+        // caller helps with the ones left. Neither can dispatch nested batches to the workers.
+        void ParallelFor(unsigned count, const std::function<void(unsigned)>& func,
+                         const std::function<void()>& callerFunc = {});
+
+        unsigned GetWorkerCount() const
+        {
+            return static_cast<unsigned>(m_Workers.size());
+        }
+
+        // Number of threads that can run jobs at the same time, the workers plus the caller
+        unsigned GetConcurrency() const
+        {
+            return GetWorkerCount() + 1;
+        }
+
+        // Shared engine pool, one worker per hardware thread besides the main thread
+        static ThreadPool& Get();
+
+    private:
+        void WorkerLoop();
+        void RunJobs(const std::function<void(unsigned)>& func, unsigned count);
+
+        std::vector<std::thread> m_Workers;
+
+        // Guards the batch description and the worker bookkeeping below
+        std::mutex m_Mutex;
+        std::condition_variable m_WakeCondition;
+        std::condition_variable m_DoneCondition;
+
+        // Only one thread dispatches a batch at a time
+        std::mutex m_DispatchMutex;
+
+        const std::function<void(unsigned)>* m_Job = nullptr;
+        unsigned m_JobCount = 0;
+        unsigned m_Generation = 0;
+        unsigned m_BusyWorkers = 0;
+        bool m_Stopping = false;
+
+        std::atomic<unsigned> m_NextIndex{0};
+        std::atomic<unsigned> m_FinishedCount{0};
+    };
+}
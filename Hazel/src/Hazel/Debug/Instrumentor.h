@@ -4,6 +4,7 @@
 #include <chrono>
 #include <algorithm>
 #include <fstream>
+#include <mutex>
 
 #include <thread>
 
@@ -23,6 +24,8 @@ namespace Hazel {
 		InstrumentationSession* m_CurrentSession;
 		std::ofstream m_OutputStream;
 		int m_ProfileCount;
+		// Profiles are written from the ECS worker threads as well
+		std::mutex m_Mutex;
 	public:
 		Instrumentor()
 			: m_CurrentSession(nullptr), m_ProfileCount(0) {}
@@ -42,6 +45,7 @@ namespace Hazel {
 		}
 
 		void WriteProfile(const ProfileResult& result) {
+			std::lock_guard<std::mutex> lock(m_Mutex);
 			if (m_ProfileCount++ > 0)
 				m_OutputStream << ",";
 
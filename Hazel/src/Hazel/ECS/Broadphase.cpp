@@ -0,0 +1,280 @@
+#include "hzpch.h"
+#include "Broadphase.h"
+
+#include "Hazel/Debug/Instrumentor.h"
+
+namespace Hazel
+{
+    namespace
+    {
+        // Boxes further out share the outermost bands, which keeps the band array bounded
+        constexpr float MAX_BAND = float(1 << 16);
+
+        void AddPair(Entity a, Entity b, std::vector<OverlapPair>& pairs)
+        {
+            pairs.push_back(a < b ? OverlapPair{a, b} : OverlapPair{b, a});
+        }
+
+        bool OverlapsY(const AABB& lhs, const AABB& rhs)
+        {
+            return lhs.Min.y <= rhs.Max.y && rhs.Min.y <= lhs.Max.y;
+        }
+    }
+
+    SweepAndPrune::SweepAndPrune(float bandHeight) : m_BandHeight(bandHeight), m_InverseBandHeight(1.0f / bandHeight)
+    {
+        HZ_CORE_ASSERT(bandHeight > 0.0f, "Broadphase bands need a positive height.");
+    }
+
+    void SweepAndPrune::Insert(Entity entity, const AABB& bounds)
+    {
+        HZ_CORE_ASSERT(!Contains(entity), "Entity inserted into the broadphase more than once.");
+
+        const unsigned index = EntityIndex(entity);
+        if (index >= m_Locations.size())
+        {
+            m_Locations.resize(index + 1);
+        }
+
+        const int bandIndex = BandOf(bounds);
+        Band& band = GetBand(bandIndex);
+        m_Locations[index] = {entity, bandIndex, static_cast<unsigned>(band.Proxies.size())};
+        band.Proxies.push_back({bounds, entity});
+
+        m_MaxHeight = std::max(m_MaxHeight, bounds.Max.y - bounds.Min.y);
+        ++m_Count;
+    }
+
+    void SweepAndPrune::Update(Entity entity, const AABB& bounds)
+    {
+        const unsigned index = EntityIndex(entity);
+        if (index < m_Locations.size() && m_Locations[index].Handle != NULL_ENTITY)
+        {
+            const Location location = m_Locations[index];
+            if (location.Handle == entity && location.Band == BandOf(bounds))
+            {
+                // Still in the same band, the next sort moves it along x
+                m_Bands[location.Band - m_FirstBand].Proxies[location.Slot].Bounds = bounds;
+                m_MaxHeight = std::max(m_MaxHeight, bounds.Max.y - bounds.Min.y);
+                return;
+            }
+
+            // Moved to another band, or the slot was reused by a new entity
+            Remove(location.Handle);
+        }
+        Insert(entity, bounds);
+    }
+
+    bool SweepAndPrune::Remove(Entity entity)
+    {
+        if (!Contains(entity))
+        {
+            return false;
+        }
+
+        Location& location = m_Locations[EntityIndex(entity)];
+        Band& band = m_Bands[location.Band - m_FirstBand];
+        band.Proxies[location.Slot].Handle = NULL_ENTITY;
+        band.HasRemovals = true;
+        location = Location();
+        --m_Count;
+        return true;
+    }
+
+    bool SweepAndPrune::Contains(Entity entity) const
+    {
+        const unsigned index = EntityIndex(entity);
+        return index < m_Locations.size() && m_Locations[index].Handle == entity;
+    }
+
+    void SweepAndPrune::Clear()
+    {
+        m_Bands.clear();
+        m_FirstBand = 0;
+        m_Locations.clear();
+        m_MaxHeight = 0.0f;
+        m_Count = 0;
+    }
+
+    void SweepAndPrune::FindPairs(std::vector<OverlapPair>& pairs)
+    {
+        HZ_PROFILE_FUNCTION();
+
+        for (Band& band : m_Bands)
+        {
+            Compact(band);
+            Sort(band);
+        }
+
+        // A box can only reach this many bands above the one of its bottom edge
+        const size_t reach = static_cast<size_t>(std::min(m_MaxHeight * m_InverseBandHeight, float(m_Bands.size()))) + 1;
+
+        pairs.clear();
+        for (size_t i = 0; i < m_Bands.size(); ++i)
+        {
+            if (m_Bands[i].Proxies.empty())
+            {
+                continue;
+            }
+
+            Sweep(m_Bands[i], pairs);
+            for (size_t above = i + 1; above <= i + reach && above < m_Bands.size(); ++above)
+            {
+                Sweep(m_Bands[i], m_Bands[above], pairs);
+            }
+        }
+
+        std::sort(pairs.begin(), pairs.end(), [](const OverlapPair& lhs, const OverlapPair& rhs)
+        {
+            return lhs.Key() < rhs.Key();
+        });
+    }
+
+    int SweepAndPrune::BandOf(const AABB& bounds) const
+    {
+        // Written so that NaN lands in a band too
+        const float band = std::floor(bounds.Min.y * m_InverseBandHeight);
+        return static_cast<int>(!(band > -MAX_BAND) ? -MAX_BAND : band < MAX_BAND ? band : MAX_BAND);
+    }
+
+    SweepAndPrune::Band& SweepAndPrune::GetBand(int band)
+    {
+        if (m_Bands.empty())
+        {
+            m_FirstBand = band;
+        }
+        if (band < m_FirstBand)
+        {
+            m_Bands.insert(m_Bands.begin(), static_cast<size_t>(m_FirstBand - band), Band());
+            m_FirstBand = band;
+        }
+        const size_t index = static_cast<size_t>(band - m_FirstBand);
+        if (index >= m_Bands.size())
+        {
+            m_Bands.resize(index + 1);
+        }
+        return m_Bands[index];
+    }
+
+    void SweepAndPrune::Compact(Band& band)
+    {
+        if (!band.HasRemovals)
+        {
+            return;
+        }
+
+        // Keeps the relative order, so the sorted prefix stays sorted
+        size_t kept = 0;
+        size_t keptSorted = 0;
+        for (size_t i = 0; i < band.Proxies.size(); ++i)
+        {
+            const Proxy& proxy = band.Proxies[i];
+            if (proxy.Handle == NULL_ENTITY)
+            {
+                continue;
+            }
+            if (i < band.SortedCount)
+            {
+                ++keptSorted;
+            }
+            m_Locations[EntityIndex(proxy.Handle)].Slot = static_cast<unsigned>(kept);
+            band.Proxies[kept++] = proxy;
+        }
+        band.Proxies.resize(kept);
+        band.SortedCount = keptSorted;
+        band.HasRemovals = false;
+    }
+
+    void SweepAndPrune::Sort(Band& band)
+    {
+        const auto lessX = [](const Proxy& lhs, const Proxy& rhs)
+        {
+            return lhs.Bounds.Min.x < rhs.Bounds.Min.x;
+        };
+        auto& proxies = band.Proxies;
+
+        // Proxies only moved a little since the last sort, each is shifted by a few places at most
+        for (size_t i = 1; i < band.SortedCount; ++i)
+        {
+            if (!lessX(proxies[i], proxies[i - 1]))
+            {
+                continue;
+            }
+
+            const Proxy moving = proxies[i];
+            size_t j = i;
+            for (; j > 0 && lessX(moving, proxies[j - 1]); --j)
+            {
+                proxies[j] = proxies[j - 1];
+                m_Locations[EntityIndex(proxies[j].Handle)].Slot = static_cast<unsigned>(j);
+            }
+            proxies[j] = moving;
+            m_Locations[EntityIndex(moving.Handle)].Slot = static_cast<unsigned>(j);
+        }
+
+        // New proxies can land anywhere, they are sorted on their own and merged in
+        if (band.SortedCount < proxies.size())
+        {
+            const auto middle = proxies.begin() + band.SortedCount;
+            std::sort(middle, proxies.end(), lessX);
+            std::inplace_merge(proxies.begin(), middle, proxies.end(), lessX);
+            for (size_t i = 0; i < proxies.size(); ++i)
+            {
+                m_Locations[EntityIndex(proxies[i].Handle)].Slot = static_cast<unsigned>(i);
+            }
+            band.SortedCount = proxies.size();
+        }
+    }
+
+    void SweepAndPrune::Sweep(const Band& band, std::vector<OverlapPair>& pairs)
+    {
+        const auto& proxies = band.Proxies;
+        for (size_t i = 0; i < proxies.size(); ++i)
+        {
+            const Proxy& proxy = proxies[i];
+
+            // Every later proxy starts further right, the first one past the right edge ends the sweep
+            for (size_t j = i + 1; j < proxies.size() && proxies[j].Bounds.Min.x <= proxy.Bounds.Max.x; ++j)
+            {
+                if (OverlapsY(proxy.Bounds, proxies[j].Bounds))
+                {
+                    AddPair(proxy.Handle, proxies[j].Handle, pairs);
+                }
+            }
+        }
+    }
+
+    void SweepAndPrune::Sweep(const Band& lower, const Band& upper, std::vector<OverlapPair>& pairs)
+    {
+        // Walks both bands in order of left edges, each pair is found from the box starting first
+        const auto& first = lower.Proxies;
+        const auto& second = upper.Proxies;
+        size_t i = 0;
+        size_t j = 0;
+        while (i < first.size() && j < second.size())
+        {
+            if (first[i].Bounds.Min.x <= second[j].Bounds.Min.x)
+            {
+                const Proxy& proxy = first[i++];
+                for (size_t k = j; k < second.size() && second[k].Bounds.Min.x <= proxy.Bounds.Max.x; ++k)
+                {
+                    if (OverlapsY(proxy.Bounds, second[k].Bounds))
+                    {
+                        AddPair(proxy.Handle, second[k].Handle, pairs);
+                    }
+                }
+            }
+            else
+            {
+                const Proxy& proxy = second[j++];
+                for (size_t k = i; k < first.size() && first[k].Bounds.Min.x <= proxy.Bounds.Max.x; ++k)
+                {
+                    if (OverlapsY(proxy.Bounds, first[k].Bounds))
+                    {
+                        AddPair(proxy.Handle, first[k].Handle, pairs);
+                    }
+                }
+            }
+        }
+    }
+}
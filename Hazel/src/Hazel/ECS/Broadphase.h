@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Hazel/Core/AABB.h"
+#include "ECSTypeDefs.h"
+
+namespace Hazel
+{
+    // Two entities whose bounds overlap, the smaller handle first
+    struct OverlapPair
+    {
+        Entity A;
+        Entity B;
+
+        uint64_t Key() const
+        {
+            return (uint64_t(A) << 32) | B;
+        }
+
+        static OverlapPair FromKey(uint64_t key)
+        {
+            return {static_cast<Entity>(key >> 32), static_cast<Entity>(key)};
+        }
+    };
+
+    enum class ContactState : unsigned char
+    {
+        Begin, Stay, End
+    };
+
+    // A pair of entities that started, kept or stopped overlapping, the smaller handle first. The
+    // entities of an End event may have been destroyed since.
+    struct ContactEvent
+    {
+        Entity A;
+        Entity B;
+        ContactState State;
+    };
+
+    // Sweep and prune along x within horizontal bands. Every box is filed under the band of its
+    // bottom edge, and the boxes of a band stay sorted by their left edge between calls, so after
+    // small movements an insertion sort restores the order in close to linear time. A band is swept
+    // against itself and the bands above it that the tallest box can reach, so only boxes close on
+    // both axes are compared. Best with bands a few times as tall as the typical box.
+    class SweepAndPrune
+    {
+    public:
+        explicit SweepAndPrune(float bandHeight = 4.0f);
+
+        // Additions are merged into the order by the next FindPairs
+        void Insert(Entity entity, const AABB& bounds);
+
+        // Inserts the entity if it is not in the broadphase yet
+        void Update(Entity entity, const AABB& bounds);
+
+        // Removals are compacted away by the next FindPairs
+        bool Remove(Entity entity);
+        bool Contains(Entity entity) const;
+        void Clear();
+
+        // Restores the order and replaces pairs with every overlapping pair, sorted by key
+        void FindPairs(std::vector<OverlapPair>& pairs);
+
+        size_t Size() const
+        {
+            return m_Count;
+        }
+
+    private:
+        struct Proxy
+        {
+            AABB Bounds;
+            Entity Handle;
+        };
+
+        struct Band
+        {
+            // Sorted by Bounds.Min.x up to SortedCount, later ones were inserted since. Removed
+            // proxies hold NULL_ENTITY until compacted.
+            std::vector<Proxy> Proxies;
+            size_t SortedCount = 0;
+            bool HasRemovals = false;
+        };
+
+        struct Location
+        {
+            Entity Handle = NULL_ENTITY;
+            int Band = 0;
+            unsigned Slot = 0;
+        };
+
+        int BandOf(const AABB& bounds) const;
+        Band& GetBand(int band);
+
+        void Compact(Band& band);
+        void Sort(Band& band);
+        static void Sweep(const Band& band, std::vector<OverlapPair>& pairs);
+        static void Sweep(const Band& lower, const Band& upper, std::vector<OverlapPair>& pairs);
+
+        // m_Bands[i] is band m_FirstBand + i, grown to cover every band in use
+        std::vector<Band> m_Bands;
+        int m_FirstBand = 0;
+
+        // Indexed by entity slot
+        std::vector<Location> m_Locations;
+
+        float m_BandHeight;
+        float m_InverseBandHeight;
+        float m_MaxHeight = 0.0f;
+        size_t m_Count = 0;
+    };
+}
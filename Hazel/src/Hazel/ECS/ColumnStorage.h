@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ComponentTraits.h"
+#include "ECSTypeDefs.h"
+#include "PagedVector.h"
+
+namespace Hazel
+{
+    // Contiguous run of count elements
+    template <typename T>
+    class ColumnSpan
+    {
+    public:
+        ColumnSpan(T* data, unsigned size) : m_Data(data), m_Size(size)
+        {
+        }
+
+        T& operator[](unsigned index) const
+        {
+            return m_Data[index];
+        }
+
+        T* Data() const
+        {
+            return m_Data;
+        }
+
+        unsigned Size() const
+        {
+            return m_Size;
+        }
+
+        T* begin() const
+        {
+            return m_Data;
+        }
+
+        T* end() const
+        {
+            return m_Data + m_Size;
+        }
+
+    private:
+        T* m_Data;
+        unsigned m_Size;
+    };
+
+    template <typename T, typename Layout = typename ComponentTraits<std::remove_const_t<T>>::Columns>
+    class ColumnRef;
+
+    // Stands in for a reference to a component stored in columns. Get<&T::Member>() is a reference
+    // to one member, converting to T gathers all of them and assigning a T scatters it. Const if T is.
+    template <typename T, auto... Members>
+    class ColumnRef<T, ColumnLayout<Members...>>
+    {
+        using Component = std::remove_const_t<T>;
+
+        template <auto Member>
+        using Field = std::conditional_t<std::is_const_v<T>, const MemberType<Member>, MemberType<Member>>;
+
+    public:
+        explicit ColumnRef(Field<Members>*... fields) : m_Fields(fields...)
+        {
+        }
+
+        ColumnRef(const ColumnRef&) = default;
+
+        template <auto Member>
+        Field<Member>& Get() const
+        {
+            constexpr size_t index = ColumnIndex<Member, Members...>();
+            static_assert(index < sizeof...(Members), "Member is not one of the component's columns.");
+            return *std::get<index>(m_Fields);
+        }
+
+        operator Component() const
+        {
+            Component value{};
+            ((value.*Members = Get<Members>()), ...);
+            return value;
+        }
+
+        // Assignment writes the referenced component, it never rebinds
+        const ColumnRef& operator=(const Component& value) const
+        {
+            static_assert(!std::is_const_v<T>, "Assigning through a const column reference.");
+            ((Get<Members>() = value.*Members), ...);
+            return *this;
+        }
+
+        const ColumnRef& operator=(const ColumnRef& other) const
+        {
+            return *this = static_cast<Component>(other);
+        }
+
+    private:
+        std::tuple<Field<Members>*...> m_Fields;
+    };
+
+    template <typename T, typename Layout = typename ComponentTraits<std::remove_const_t<T>>::Columns>
+    class ColumnChunk;
+
+    // Consecutive packed components in columns and the entities owning them, handed out by views
+    // for kernels that process whole arrays. Every column starts on a cache line.
+    template <typename T, auto... Members>
+    class ColumnChunk<T, ColumnLayout<Members...>>
+    {
+        template <auto Member>
+        using Field = std::conditional_t<std::is_const_v<T>, const MemberType<Member>, MemberType<Member>>;
+
+    public:
+        ColumnChunk(const Entity* entities, unsigned size, Field<Members>*... columns)
+            : m_Entities(entities), m_Size(size), m_Columns(columns...)
+        {
+        }
+
+        unsigned Size() const
+        {
+            return m_Size;
+        }
+
+        ColumnSpan<const Entity> Entities() const
+        {
+            return {m_Entities, m_Size};
+        }
+
+        template <auto Member>
+        ColumnSpan<Field<Member>> Get() const
+        {
+            constexpr size_t index = ColumnIndex<Member, Members...>();
+            static_assert(index < sizeof...(Members), "Member is not one of the component's columns.");
+            return {std::get<index>(m_Columns), m_Size};
+        }
+
+    private:
+        const Entity* m_Entities;
+        unsigned m_Size;
+        std::tuple<Field<Members>*...> m_Columns;
+    };
+
+    template <typename T, unsigned PageSize, typename Layout = typename ComponentTraits<T>::Columns>
+    class ColumnStorage;
+
+    // Packed components of type T split into one PagedVector per member. The columns share their
+    // page size, so page p of each column holds the same components. Offers the subset of the
+    // PagedVector interface that component pools use, with ColumnRef in place of references.
+    template <typename T, unsigned PageSize, auto... Members>
+    class ColumnStorage<T, PageSize, ColumnLayout<Members...>>
+    {
+        static_assert(std::is_default_constructible_v<T>, "Components stored in columns must be default constructible.");
+
+    public:
+        static constexpr unsigned PAGE_SIZE = PageSize;
+
+        // Older values per column, and every index at which any column differs
+        struct Delta
+        {
+            std::tuple<ElementDelta<MemberType<Members>>...> Columns;
+            std::vector<unsigned> Indices;
+
+            size_t GetMemoryUsage() const
+            {
+                return Indices.capacity() * sizeof(unsigned) +
+                    std::apply([](const auto&... columns) { return (columns.GetMemoryUsage() + ...); }, Columns);
+            }
+        };
+
+        // Storage over count components whose columns lie in external memory that stays alive as
+        // long as owner does, without copying them. Every column must be padded to a whole number
+        // of pages.
+        static ColumnStorage Adopt(unsigned count, const Ref<void>& owner, MemberType<Members>*... columns)
+        {
+            ColumnStorage storage;
+            ((storage.Column<Members>() = PagedVector<MemberType<Members>, PageSize>::Adopt(columns, count, owner)), ...);
+            return storage;
+        }
+
+        ColumnRef<const T> operator[](unsigned index) const
+        {
+            return ColumnRef<const T>(&Column<Members>()[index]...);
+        }
+
+        // Write access, clones the pages of every column first if a copy still shares them
+        ColumnRef<T> Mutable(unsigned index)
+        {
+            return ColumnRef<T>(&Column<Members>().Mutable(index)...);
+        }
+
+        void EmplaceBack(const T& value)
+        {
+            (Column<Members>().EmplaceBack(value.*Members), ...);
+        }
+
+        void PopBack()
+        {
+            (Column<Members>().PopBack(), ...);
+        }
+
+        void Swap(unsigned first, unsigned second)
+        {
+            (std::swap(Column<Members>().Mutable(first), Column<Members>().Mutable(second)), ...);
+        }
+
+        void Clear()
+        {
+            (Column<Members>().Clear(), ...);
+        }
+
+        void Reserve(unsigned capacity)
+        {
+            (Column<Members>().Reserve(capacity), ...);
+        }
+
+        void ShrinkToFit()
+        {
+            (Column<Members>().ShrinkToFit(), ...);
+        }
+
+        void MakeUnique()
+        {
+            (Column<Members>().MakeUnique(), ...);
+        }
+
+        unsigned Size() const
+        {
+            return std::get<0>(m_Columns).Size();
+        }
+
+        bool Empty() const
+        {
+            return Size() == 0;
+        }
+
+        // The whole column of one member, element i belonging to component i
+        template <auto Member>
+        const PagedVector<MemberType<Member>, PageSize>& Column() const
+        {
+            constexpr size_t index = ColumnIndex<Member, Members...>();
+            static_assert(index < sizeof...(Members), "Member is not one of the component's columns.");
+            return std::get<index>(m_Columns);
+        }
+
+        // Columns from packed index begin on for count components, which must not cross a page
+        ColumnChunk<const T> Chunk(const Entity* entities, unsigned begin, unsigned count) const
+        {
+            HZ_CORE_ASSERT(count == 0 || begin / PageSize == (begin + count - 1) / PageSize, "Chunk crosses a page.");
+            return ColumnChunk<const T>(entities, count, &Column<Members>()[begin]...);
+        }
+
+        ColumnChunk<T> Chunk(const Entity* entities, unsigned begin, unsigned count)
+        {
+            HZ_CORE_ASSERT(count == 0 || begin / PageSize == (begin + count - 1) / PageSize, "Chunk crosses a page.");
+            return ColumnChunk<T>(entities, count, &Column<Members>().Mutable(begin)...);
+        }
+
+        Delta Diff(const ColumnStorage& older) const
+        {
+            Delta delta;
+            delta.Columns = std::make_tuple(Column<Members>().Diff(older.template Column<Members>())...);
+            std::apply([&delta](const auto&... columns)
+            {
+                (delta.Indices.insert(delta.Indices.end(), columns.Indices.begin(), columns.Indices.end()), ...);
+            }, delta.Columns);
+            std::sort(delta.Indices.begin(), delta.Indices.end());
+            delta.Indices.erase(std::unique(delta.Indices.begin(), delta.Indices.end()), delta.Indices.end());
+            return delta;
+        }
+
+        void Revert(const Delta& delta)
+        {
+            (Column<Members>().Revert(std::get<ColumnIndex<Members, Members...>()>(delta.Columns)), ...);
+        }
+
+    private:
+        template <auto Member>
+        PagedVector<MemberType<Member>, PageSize>& Column()
+        {
+            return std::get<ColumnIndex<Member, Members...>()>(m_Columns);
+        }
+
+        std::tuple<PagedVector<MemberType<Members>, PageSize>...> m_Columns;
+    };
+}
@@ -0,0 +1,695 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Hazel/Core/Core.h"
+#include "ColumnStorage.h"
+#include "ComponentTraits.h"
+#include "ECSTypeDefs.h"
+#include "EntitySet.h"
+#include "PagedVector.h"
+#include "SharedStorage.h"
+
+namespace Hazel
+{
+    class IComponentArray
+    {
+    public:
+        // How an older version of a pool differs from a newer one, see Diff()
+        struct Delta
+        {
+            virtual ~Delta() = default;
+            virtual size_t GetMemoryUsage() const = 0;
+        };
+
+        virtual ~IComponentArray() = default;
+        virtual void EntityDestroyed(Entity entity) = 0;
+
+        virtual Ref<IComponentArray> Clone() const = 0;
+
+        // Records what Revert() needs to turn this pool back into older, a pool of the same type.
+        // Only pages written since older was copied are compared.
+        virtual Scope<Delta> Diff(const IComponentArray& older) const = 0;
+        virtual void Revert(const Delta& delta) = 0;
+
+        // Pre-allocates storage for capacity components
+        virtual void Reserve(unsigned capacity) = 0;
+
+        // Releases pages that no longer hold any components
+        virtual void ShrinkToFit() = 0;
+
+        // Removes every component without notifying anyone
+        virtual void Clear() = 0;
+
+        // The tick that additions and writes are stamped with, owned by the component manager
+        virtual void BindChangeTick(const ChangeTick* tick) = 0;
+
+        // Moves the entity's component to the enabled or the disabled part of the pool
+        virtual void SetEntityEnabled(Entity entity, bool enabled) = 0;
+
+        // Moves the entity's enabled component into or out of the group prefix of the pool, see
+        // ECS::RegisterGroup
+        virtual void SetEntityGrouped(Entity entity, bool grouped) = 0;
+
+        // The entities having the component, in packed order
+        virtual const EntitySet& Entities() const = 0;
+
+        // Rearranges the packed entries [begin, begin + order.size()) so that entry begin + i is the
+        // one that was at begin + order[i]. Entries never move out of the range.
+        virtual void Permute(unsigned begin, const std::vector<unsigned>& order) = 0;
+    };
+
+    // Largest power of two count of elements of the given size that fits into 16 KiB (at least one),
+    // so that page lookups stay shifts and masks
+    constexpr unsigned ComponentPageSize(size_t elementSize)
+    {
+        unsigned count = 1;
+        while (count * 2 * elementSize <= 16384)
+        {
+            count *= 2;
+        }
+        return count;
+    }
+
+    // What accessors of a component hand out: a reference, a ColumnRef for columnar components, or
+    // a const reference for shared components, which are read-only
+    template <typename T>
+    using ComponentReference = std::conditional_t<IsColumnar<T>::value, ColumnRef<T>,
+                                                  std::conditional_t<IsShared<T>::value, const std::remove_const_t<T>&, T&>>;
+
+    // Components of one type, packed. The components of disabled entities are kept behind those of
+    // enabled ones, so that views walk [0, ActiveSize()) and never visit them. A pool owned by a
+    // group starts with the group's members, [0, GroupSize()) lines up across the group's pools.
+    // Empty types are tags: the pool only keeps the set of entities that have them, there is no
+    // component data. Types with columns in their ComponentTraits are stored as one array per member,
+    // shared types as indices into a table of their distinct values.
+    template <typename T>
+    class ComponentArray : public IComponentArray
+    {
+    public:
+        static constexpr bool IS_TAG = std::is_empty_v<T>;
+        static constexpr bool IS_COLUMNAR = IsColumnar<T>::value;
+        static constexpr bool IS_SHARED = IsShared<T>::value;
+        static_assert(!(IS_SHARED && (IS_COLUMNAR || IS_TAG)), "Shared components are neither columnar nor tags.");
+
+        // Move-only components work as long as the pool is not copied or recorded while it holds any
+        static constexpr bool IS_COPYABLE = std::is_copy_constructible_v<T>;
+
+        // Number of components stored in one page of the packed array, of each column or of the
+        // shared value indices
+        static constexpr unsigned PAGE_SIZE = ComponentPageSize(IS_SHARED ? sizeof(SharedIndex) : sizeof(T));
+
+        // Packed indices per ColumnChunk, chunks never cross a page of the columns or the entities
+        static constexpr unsigned CHUNK_SIZE = std::min(PAGE_SIZE, EntitySet::PACKED_PAGE_SIZE);
+
+        using Storage = std::conditional_t<IS_COLUMNAR, ColumnStorage<T, PAGE_SIZE>,
+                                           std::conditional_t<IS_SHARED, SharedStorage<T, PAGE_SIZE>, PagedVector<T, PAGE_SIZE>>>;
+        using Reference = ComponentReference<T>;
+        using ConstReference = ComponentReference<const T>;
+
+        explicit ComponentArray(unsigned initialCapacity = 0)
+        {
+            Reserve(initialCapacity);
+        }
+
+        Ref<IComponentArray> Clone() const override
+        {
+            HZ_CORE_ASSERT(IS_COPYABLE || Size() == 0, "Copying a pool of move-only components.");
+            return std::static_pointer_cast<IComponentArray>(std::make_shared<ComponentArray<T>>(*this));
+        }
+
+        Scope<IComponentArray::Delta> Diff(const IComponentArray& older) const override
+        {
+            const auto& olderArray = static_cast<const ComponentArray<T>&>(older);
+            auto delta = CreateScope<PoolDelta>();
+            if constexpr (IS_COPYABLE)
+            {
+                delta->Components = m_Components.Diff(olderArray.m_Components);
+            }
+            else
+            {
+                HZ_CORE_ASSERT(Size() == 0 && olderArray.Size() == 0, "Recording a pool of move-only components.");
+            }
+            delta->Entities = m_Entities.Diff(olderArray.m_Entities);
+            delta->ChangedTicks = m_ChangedTicks.Diff(olderArray.m_ChangedTicks);
+            delta->AddedTicks = m_AddedTicks.Diff(olderArray.m_AddedTicks);
+            delta->ActiveCount = olderArray.m_ActiveCount;
+            delta->GroupCount = olderArray.m_GroupCount;
+            return delta;
+        }
+
+        void Revert(const IComponentArray::Delta& delta) override
+        {
+            const auto& poolDelta = static_cast<const PoolDelta&>(delta);
+            if constexpr (IS_COPYABLE)
+            {
+                m_Components.Revert(poolDelta.Components);
+            }
+            m_Entities.Revert(poolDelta.Entities);
+            m_ChangedTicks.Revert(poolDelta.ChangedTicks);
+            m_AddedTicks.Revert(poolDelta.AddedTicks);
+            m_ActiveCount = poolDelta.ActiveCount;
+            m_GroupCount = poolDelta.GroupCount;
+
+            if (!m_TrackChanges)
+            {
+                return;
+            }
+
+            // Tracking was turned on after the older state was recorded
+            if (m_ChangedTicks.Size() != Size())
+            {
+                StampAll();
+                return;
+            }
+
+            // Restored values are changes too, e.g. to a spatial index kept in sync through them
+            for (const unsigned index : poolDelta.Components.Indices)
+            {
+                if (index < Size())
+                {
+                    m_ChangedTicks.Mutable(index) = *m_ChangeTick;
+                }
+            }
+        }
+
+        // enabled is false if the entity is disabled
+        void InsertData(Entity entity, T component, bool enabled = true)
+        {
+            EmplaceData(entity, enabled, std::move(component));
+        }
+
+        // Constructs the component from args in place. Columnar and shared components are built
+        // first and then moved into their columns or the value table.
+        template <typename... Args>
+        void EmplaceData(Entity entity, bool enabled, Args&&... args)
+        {
+            HZ_CORE_ASSERT(!Contains(entity), "Component added to same entity more than once.");
+
+            // Put new entry at end, the entity set hands out the same packed index
+            if constexpr (IS_COLUMNAR || IS_SHARED)
+            {
+                m_Components.EmplaceBack(MakeElement<T>(std::forward<Args>(args)...));
+            }
+            else if constexpr (!IS_TAG)
+            {
+                m_Components.EmplaceBack(std::forward<Args>(args)...);
+            }
+            m_Entities.Insert(entity);
+            if (m_TrackChanges)
+            {
+                m_ChangedTicks.EmplaceBack(*m_ChangeTick);
+                m_AddedTicks.EmplaceBack(*m_ChangeTick);
+            }
+
+            // Enabled entities go in front of the disabled ones
+            if (enabled)
+            {
+                SwapEntries(m_ActiveCount++, Size() - 1);
+            }
+        }
+
+        void RemoveData(Entity entity)
+        {
+            HZ_CORE_ASSERT(Contains(entity), "Removing non-existent component.");
+
+            // An enabled entry first trades places with the last enabled one, so that the
+            // swap below only moves a disabled entry and the partition stays intact
+            unsigned indexOfRemovedEntity = m_Entities.Find(entity);
+            HZ_CORE_ASSERT(indexOfRemovedEntity >= m_GroupCount, "Removing a component before its entity left the group.");
+            if (indexOfRemovedEntity < m_ActiveCount)
+            {
+                SwapEntries(indexOfRemovedEntity, --m_ActiveCount);
+                indexOfRemovedEntity = m_ActiveCount;
+            }
+
+            // Move element at end into deleted element's place to maintain density,
+            // the entity set performs the same swap on its side. Ticks move along, the
+            // moved component was not written.
+            unsigned indexOfLastElement = m_Entities.Size() - 1;
+            if (indexOfRemovedEntity != indexOfLastElement)
+            {
+                if constexpr (IS_SHARED)
+                {
+                    // Popping the removed one releases its value
+                    m_Components.Swap(indexOfRemovedEntity, indexOfLastElement);
+                }
+                else if constexpr (IS_COLUMNAR)
+                {
+                    m_Components.Mutable(indexOfRemovedEntity) = m_Components[indexOfLastElement];
+                }
+                else if constexpr (!IS_TAG)
+                {
+                    m_Components.Mutable(indexOfRemovedEntity) = std::move(m_Components.Mutable(indexOfLastElement));
+                }
+                if (m_TrackChanges)
+                {
+                    m_ChangedTicks.Mutable(indexOfRemovedEntity) = m_ChangedTicks[indexOfLastElement];
+                    m_AddedTicks.Mutable(indexOfRemovedEntity) = m_AddedTicks[indexOfLastElement];
+                }
+            }
+            if constexpr (!IS_TAG)
+            {
+                m_Components.PopBack();
+            }
+            m_Entities.Erase(entity);
+            if (m_TrackChanges)
+            {
+                m_ChangedTicks.PopBack();
+                m_AddedTicks.PopBack();
+            }
+        }
+
+        // Overwrites the entity's component, counts as a write. The way to change a shared component.
+        void ReplaceData(Entity entity, T component)
+        {
+            HZ_CORE_ASSERT(Contains(entity), "Replacing non-existent component.");
+
+            const unsigned index = m_Entities.Find(entity);
+            if constexpr (IS_SHARED)
+            {
+                m_Components.Replace(index, std::move(component));
+                if (m_TrackChanges)
+                {
+                    m_ChangedTicks.Mutable(index) = *m_ChangeTick;
+                }
+            }
+            else
+            {
+                At(index) = std::move(component);
+            }
+        }
+
+        Reference GetData(Entity entity)
+        {
+            HZ_CORE_ASSERT(Contains(entity), "Retrieving non-existent component.");
+
+            // Return a reference to the entity's component
+            return At(m_Entities.Find(entity));
+        }
+
+        // Read access, never clones a page shared with a snapshot
+        ConstReference GetData(Entity entity) const
+        {
+            HZ_CORE_ASSERT(Contains(entity), "Retrieving non-existent component.");
+            return At(m_Entities.Find(entity));
+        }
+
+        // Single probe for views: the entity's component, or nullptr if it has none
+        // Shared components are read-only, a const pointer for them
+        std::conditional_t<IS_SHARED, const T*, T*> TryGet(Entity entity)
+        {
+            static_assert(!IS_COLUMNAR, "Columnar components have no address, use IndexOf() and At().");
+            const unsigned packedIndex = m_Entities.Find(entity);
+            return packedIndex != EntitySet::INVALID_INDEX ? &At(packedIndex) : nullptr;
+        }
+
+        const T* TryGet(Entity entity) const
+        {
+            static_assert(!IS_COLUMNAR, "Columnar components have no address, use IndexOf() and At().");
+            const unsigned packedIndex = m_Entities.Find(entity);
+            return packedIndex != EntitySet::INVALID_INDEX ? &At(packedIndex) : nullptr;
+        }
+
+        bool Contains(Entity entity) const
+        {
+            return m_Entities.Contains(entity);
+        }
+
+        // Packed index of the entity's component, EntitySet::INVALID_INDEX if it has none
+        unsigned IndexOf(Entity entity) const
+        {
+            return m_Entities.Find(entity);
+        }
+
+        void EntityDestroyed(Entity entity) override
+        {
+            if (Contains(entity))
+            {
+                // Remove the entity's component if it existed
+                RemoveData(entity);
+            }
+        }
+
+        void SetEntityEnabled(Entity entity, bool enabled) override
+        {
+            HZ_CORE_ASSERT(Contains(entity), "Enabling non-existent component.");
+
+            const unsigned index = m_Entities.Find(entity);
+            if (enabled && index >= m_ActiveCount)
+            {
+                SwapEntries(index, m_ActiveCount++);
+            }
+            else if (!enabled && index < m_ActiveCount)
+            {
+                HZ_CORE_ASSERT(index >= m_GroupCount, "Disabling an entity before it left the group.");
+                SwapEntries(index, --m_ActiveCount);
+            }
+        }
+
+        void SetEntityGrouped(Entity entity, bool grouped) override
+        {
+            HZ_CORE_ASSERT(Contains(entity), "Grouping non-existent component.");
+
+            const unsigned index = m_Entities.Find(entity);
+            HZ_CORE_ASSERT(index < m_ActiveCount, "Grouping a disabled entity.");
+            if (grouped && index >= m_GroupCount)
+            {
+                SwapEntries(index, m_GroupCount++);
+            }
+            else if (!grouped && index < m_GroupCount)
+            {
+                SwapEntries(index, --m_GroupCount);
+            }
+        }
+
+        // Follows the cycles of the permutation, one swap per entry out of place. Moving entries does
+        // not count as writing them.
+        void Permute(unsigned begin, const std::vector<unsigned>& order) override
+        {
+            HZ_CORE_ASSERT(begin + order.size() <= Size(), "Permuting entries past the end of the pool.");
+
+            std::vector<bool> placed(order.size(), false);
+            for (unsigned start = 0; start < order.size(); ++start)
+            {
+                if (placed[start])
+                {
+                    continue;
+                }
+
+                // The entry that belongs at current is swapped in, the displaced one moves on to
+                // the place it came from until the cycle closes
+                unsigned current = start;
+                while (order[current] != start)
+                {
+                    const unsigned next = order[current];
+                    SwapEntries(begin + current, begin + next);
+                    placed[current] = true;
+                    current = next;
+                }
+                placed[current] = true;
+            }
+        }
+
+        void Reserve(unsigned capacity) override
+        {
+            if constexpr (!IS_TAG)
+            {
+                m_Components.Reserve(capacity);
+            }
+            m_Entities.Reserve(capacity);
+            if (m_TrackChanges)
+            {
+                m_ChangedTicks.Reserve(capacity);
+                m_AddedTicks.Reserve(capacity);
+            }
+        }
+
+        void ShrinkToFit() override
+        {
+            m_Components.ShrinkToFit();
+            m_Entities.ShrinkToFit();
+            m_ChangedTicks.ShrinkToFit();
+            m_AddedTicks.ShrinkToFit();
+        }
+
+        void Clear() override
+        {
+            m_Components.Clear();
+            m_Entities.Clear();
+            m_ChangedTicks.Clear();
+            m_AddedTicks.Clear();
+            m_ActiveCount = 0;
+            m_GroupCount = 0;
+        }
+
+        void BindChangeTick(const ChangeTick* tick) override
+        {
+            m_ChangeTick = tick;
+        }
+
+        // From now on additions and writes through the mutable accessors are stamped with the
+        // current tick, see ChangedTick() and AddedTick(). Components already present count as
+        // added and changed now.
+        void EnableChangeTracking()
+        {
+            HZ_CORE_ASSERT(m_ChangeTick, "Change tracking enabled on a pool without a tick.");
+            if (!m_TrackChanges)
+            {
+                m_TrackChanges = true;
+                StampAll();
+            }
+        }
+
+        bool IsTrackingChanges() const
+        {
+            return m_TrackChanges;
+        }
+
+        // Tick of the last write to component i through a mutable accessor, or of its addition
+        ChangeTick ChangedTick(unsigned index) const
+        {
+            HZ_CORE_ASSERT(m_TrackChanges, "Change tracking is not enabled for this component.");
+            return m_ChangedTicks[index];
+        }
+
+        // Tick at which component i was added
+        ChangeTick AddedTick(unsigned index) const
+        {
+            HZ_CORE_ASSERT(m_TrackChanges, "Change tracking is not enabled for this component.");
+            return m_AddedTicks[index];
+        }
+
+        // Replaces the contents, component i belonging to entities[i], with every entity enabled
+        // and none grouped. Tags take no components. Used to load worlds.
+        void Load(Storage components, EntitySet entities)
+        {
+            HZ_CORE_ASSERT(components.Size() == (IS_TAG ? 0 : entities.Size()), "Component and entity counts differ.");
+            m_Components = std::move(components);
+            m_Entities = std::move(entities);
+            m_ActiveCount = m_Entities.Size();
+            m_GroupCount = 0;
+            if (m_TrackChanges)
+            {
+                StampAll();
+            }
+        }
+
+        // Clones the pages still shared with a snapshot, so that At() can be called from several
+        // threads at once
+        void MakeUnique()
+        {
+            m_Components.MakeUnique();
+            m_ChangedTicks.MakeUnique();
+        }
+
+        // Packed access, component i belongs to EntityAt(i). Clones the page if a snapshot
+        // still shares it, references taken before a snapshot must not be written through.
+        // Counts as a write for change tracking, read through the const overload otherwise.
+        // Shared components cannot be written through it and are only read.
+        Reference At(unsigned index)
+        {
+            if (m_TrackChanges && !IS_SHARED)
+            {
+                m_ChangedTicks.Mutable(index) = *m_ChangeTick;
+            }
+            if constexpr (IS_TAG)
+            {
+                return TagInstance();
+            }
+            else if constexpr (IS_SHARED)
+            {
+                return m_Components[index];
+            }
+            else
+            {
+                return m_Components.Mutable(index);
+            }
+        }
+
+        ConstReference At(unsigned index) const
+        {
+            if constexpr (IS_TAG)
+            {
+                return TagInstance();
+            }
+            else
+            {
+                return m_Components[index];
+            }
+        }
+
+        Entity EntityAt(unsigned index) const
+        {
+            return m_Entities[index];
+        }
+
+        // The packed components [begin, begin + count), which must lie within one multiple of
+        // CHUNK_SIZE: a ColumnChunk for columnar components and a ColumnSpan of them otherwise.
+        // Counts as a write of all of them for change tracking, read through the const overload
+        // otherwise.
+        auto ChunkAt(unsigned begin, unsigned count)
+        {
+            static_assert(!IS_TAG, "Tags have no components to hand out in chunks.");
+            static_assert(!IS_SHARED, "Shared components are not stored side by side, see SharedIndexAt().");
+            if (m_TrackChanges)
+            {
+                for (unsigned i = begin; i < begin + count; ++i)
+                {
+                    m_ChangedTicks.Mutable(i) = *m_ChangeTick;
+                }
+            }
+            if constexpr (IS_COLUMNAR)
+            {
+                return m_Components.Chunk(count > 0 ? &m_Entities.Packed()[begin] : nullptr, begin, count);
+            }
+            else
+            {
+                HZ_CORE_ASSERT(count == 0 || begin / PAGE_SIZE == (begin + count - 1) / PAGE_SIZE, "Chunk crosses a page.");
+                return ColumnSpan<T>(count > 0 ? &m_Components.Mutable(begin) : nullptr, count);
+            }
+        }
+
+        auto ChunkAt(unsigned begin, unsigned count) const
+        {
+            static_assert(!IS_TAG, "Tags have no components to hand out in chunks.");
+            static_assert(!IS_SHARED, "Shared components are not stored side by side, see SharedIndexAt().");
+            if constexpr (IS_COLUMNAR)
+            {
+                return m_Components.Chunk(count > 0 ? &m_Entities.Packed()[begin] : nullptr, begin, count);
+            }
+            else
+            {
+                HZ_CORE_ASSERT(count == 0 || begin / PAGE_SIZE == (begin + count - 1) / PAGE_SIZE, "Chunk crosses a page.");
+                return ColumnSpan<const T>(count > 0 ? &m_Components[begin] : nullptr, count);
+            }
+        }
+
+        // The entities owning the packed components [begin, begin + count), within one multiple of
+        // CHUNK_SIZE
+        ColumnSpan<const Entity> EntitiesAt(unsigned begin, unsigned count) const
+        {
+            return ColumnSpan<const Entity>(count > 0 ? &m_Entities.Packed()[begin] : nullptr, count);
+        }
+
+        const Storage& Components() const
+        {
+            return m_Components;
+        }
+
+        // Identifies the value of component i among the distinct values of a shared type: equal
+        // components have the same index, e.g. to sort entities sharing a value next to each other
+        SharedIndex SharedIndexAt(unsigned index) const
+        {
+            static_assert(IS_SHARED, "Only shared components have shared indices.");
+            return m_Components.IndexAt(index);
+        }
+
+        const EntitySet& Entities() const override
+        {
+            return m_Entities;
+        }
+
+        unsigned Size() const
+        {
+            return m_Entities.Size();
+        }
+
+        // Number of components of enabled entities, they come first in packed order
+        unsigned ActiveSize() const
+        {
+            return m_ActiveCount;
+        }
+
+        // Number of components of the members of the group owning the pool, they come first
+        unsigned GroupSize() const
+        {
+            return m_GroupCount;
+        }
+
+    private:
+        struct PoolDelta : IComponentArray::Delta
+        {
+            decltype(std::declval<const Storage&>().Diff(std::declval<const Storage&>())) Components;
+            EntitySet::Delta Entities;
+            ElementDelta<ChangeTick> ChangedTicks;
+            ElementDelta<ChangeTick> AddedTicks;
+            unsigned ActiveCount = 0;
+            unsigned GroupCount = 0;
+
+            size_t GetMemoryUsage() const override
+            {
+                return Components.GetMemoryUsage() + Entities.GetMemoryUsage() +
+                    ChangedTicks.GetMemoryUsage() + AddedTicks.GetMemoryUsage();
+            }
+        };
+
+        // What At() hands out for a tag, tags have no state to write to
+        static T& TagInstance()
+        {
+            static T s_Tag;
+            return s_Tag;
+        }
+
+        // Exchanges two packed entries along with their ticks, neither counts as written
+        void SwapEntries(unsigned first, unsigned second)
+        {
+            if (first == second)
+            {
+                return;
+            }
+
+            if constexpr (IS_COLUMNAR || IS_SHARED)
+            {
+                m_Components.Swap(first, second);
+            }
+            else if constexpr (!IS_TAG)
+            {
+                std::swap(m_Components.Mutable(first), m_Components.Mutable(second));
+            }
+            if (m_TrackChanges)
+            {
+                std::swap(m_ChangedTicks.Mutable(first), m_ChangedTicks.Mutable(second));
+                std::swap(m_AddedTicks.Mutable(first), m_AddedTicks.Mutable(second));
+            }
+            m_Entities.Swap(first, second);
+        }
+
+        // Stamps every present component as added and changed at the current tick
+        void StampAll()
+        {
+            m_ChangedTicks.Clear();
+            m_AddedTicks.Clear();
+            m_ChangedTicks.Reserve(Size());
+            m_AddedTicks.Reserve(Size());
+            for (unsigned i = 0; i < Size(); ++i)
+            {
+                m_ChangedTicks.EmplaceBack(*m_ChangeTick);
+                m_AddedTicks.EmplaceBack(*m_ChangeTick);
+            }
+        }
+
+        // The packed components (of generic type T), split into fixed size pages that are
+        // allocated as the pool grows. Pages never reallocate, so references stay valid
+        // while other entities receive the component. Snapshots share the pages until
+        // either side writes to them. Always empty for tags.
+        Storage m_Components;
+
+        // Entries [0, m_ActiveCount) belong to enabled entities, the first m_GroupCount of them to
+        // members of the owning group
+        unsigned m_ActiveCount = 0;
+        unsigned m_GroupCount = 0;
+
+        // The entity owning each component, packed index i of both belongs together
+        EntitySet m_Entities;
+
+        // Per component ticks of the last write and of the addition, parallel to m_Components
+        // and empty unless change tracking is on
+        PagedVector<ChangeTick, ComponentPageSize(sizeof(ChangeTick))> m_ChangedTicks;
+        PagedVector<ChangeTick, ComponentPageSize(sizeof(ChangeTick))> m_AddedTicks;
+        const ChangeTick* m_ChangeTick = nullptr;
+        bool m_TrackChanges = false;
+    };
+}
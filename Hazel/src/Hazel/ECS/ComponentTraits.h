@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace Hazel
+{
+    // Data members of a component stored as separate columns, e.g.
+    // ColumnLayout<&Transform::Position, &Transform::Size, &Transform::Rotation>
+    template <auto... Members>
+    struct ColumnLayout
+    {
+    };
+
+    // Storage options of a component type, specialised next to the component. Setting Columns to
+    // a ColumnLayout that lists every data member stores the type as a struct of arrays: one
+    // cache line aligned array per member, so that kernels over a few members do not drag the
+    // others through the cache. Components stored that way are accessed through ColumnRef
+    // instead of references, and views of them hand out ColumnChunks.
+    // Setting Shared to true and providing a static size_t Hash(const T&) stores each distinct
+    // value once, see SharedStorage. Shared components need operator== and are read-only, they
+    // are changed by replacing them.
+    template <typename T>
+    struct ComponentTraits
+    {
+        using Columns = void;
+    };
+
+    template <typename T>
+    struct IsColumnar : std::bool_constant<!std::is_void_v<typename ComponentTraits<std::remove_const_t<T>>::Columns>>
+    {
+    };
+
+    template <typename T, typename = void>
+    struct IsShared : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct IsShared<T, std::void_t<decltype(ComponentTraits<std::remove_const_t<T>>::Shared)>>
+        : std::bool_constant<ComponentTraits<std::remove_const_t<T>>::Shared>
+    {
+    };
+
+    template <typename Class, typename Field>
+    Field MemberTypeOf(Field Class::*);
+
+    // Type of the data member a member pointer points at
+    template <auto Member>
+    using MemberType = decltype(MemberTypeOf(Member));
+
+    template <auto First, auto Second>
+    constexpr bool IsSameMember()
+    {
+        if constexpr (std::is_same_v<decltype(First), decltype(Second)>)
+        {
+            return First == Second;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // Position of Member in Members, sizeof...(Members) if it is not listed
+    template <auto Member, auto... Members>
+    constexpr size_t ColumnIndex()
+    {
+        constexpr bool matches[] = {IsSameMember<Member, Members>()..., false};
+        for (size_t i = 0; i < sizeof...(Members); ++i)
+        {
+            if (matches[i])
+            {
+                return i;
+            }
+        }
+        return sizeof...(Members);
+    }
+}
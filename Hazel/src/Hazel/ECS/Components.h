@@ -1,5 +1,10 @@
 #pragma once
+#include <functional>
+#include <vector>
+
 #include "glm/glm.hpp"
+#include "ComponentTraits.h"
+#include "ECSTypeDefs.h"
 #include "Hazel/Renderer/Texture.h"
 
 namespace Hazel
@@ -16,6 +21,13 @@ namespace Hazel
         float Rotation;
     };
 
+    // Movement and culling mostly read positions alone
+    template <>
+    struct ComponentTraits<Transform>
+    {
+        using Columns = ColumnLayout<&Transform::Position, &Transform::Size, &Transform::Rotation>;
+    };
+
     struct Colored
     {
         glm::vec4 Color;
@@ -25,6 +37,24 @@ namespace Hazel
     {
         Ref<Texture2D> Texture;
         float TilingFactor;
+
+        bool operator==(const Textured& other) const
+        {
+            return Texture == other.Texture && TilingFactor == other.TilingFactor;
+        }
+    };
+
+    // Sprites share a handful of textures, every component would hold a reference otherwise
+    template <>
+    struct ComponentTraits<Textured>
+    {
+        using Columns = void;
+        static constexpr bool Shared = true;
+
+        static size_t Hash(const Textured& textured)
+        {
+            return std::hash<Texture2D*>()(textured.Texture.get()) ^ std::hash<float>()(textured.TilingFactor) * 31;
+        }
     };
 
     // extend this to support n-gons, which are basically Ref<Mesh>es
@@ -46,8 +76,34 @@ namespace Hazel
         bool Movable;
     };
 
+    template <>
+    struct ComponentTraits<RigidBody>
+    {
+        using Columns = ColumnLayout<&RigidBody::Velocity, &RigidBody::Acceleration, &RigidBody::Mass, &RigidBody::Movable>;
+    };
+
     struct Health
     {
         float health = 1.0f;
     };
+
+    // Hierarchy links, kept consistent by ECS::SetParent and ECS::DestroyEntity. The Transform of an
+    // entity with a parent is relative to the parent's position and rotation, NULL_ENTITY makes it
+    // a root again.
+    struct Parent
+    {
+        Entity Handle = NULL_ENTITY;
+    };
+
+    struct Children
+    {
+        std::vector<Entity> Handles;
+    };
+
+    // World matrix of the quad, Size included, cached by the TransformPropagationSystem. Children
+    // inherit the position and rotation of their parent, not its size.
+    struct WorldTransform
+    {
+        glm::mat4 Matrix = glm::mat4(1.0f);
+    };
 }
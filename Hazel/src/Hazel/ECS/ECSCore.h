@@ -1,20 +1,28 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <bitset>
-#include <queue>
+#include <functional>
+#include <utility>
 #include "Hazel/Core/Core.h"
-#include <array>
-#include <unordered_map>
-#include <set>
+#include <vector>
 #include "Systems.h"
 
+#include "Hazel/Core/ThreadPool.h"
 #include "Hazel/Core/Timestep.h"
-#include <set>
+#include "Hazel/Debug/Instrumentor.h"
 #include <glm/glm.hpp>
 
 
+#include "ComponentArray.h"
 #include "Components.h"
 #include "ECSTypeDefs.h"
+#include "EntityCommandBuffer.h"
+#include "Group.h"
+#include "PagedVector.h"
+#include "Sorting.h"
+#include "View.h"
 #include "Hazel/Events/Event.h"
 #include "Hazel/Renderer/Texture.h"
 
@@ -23,189 +31,248 @@ namespace Hazel
     class EntityManager
     {
     public:
-        EntityManager()
+        // Number of slots per page of the handle and signature arrays
+        static constexpr unsigned PAGE_SIZE = 4096;
+
+        // How an older version of the manager differs from a newer one: the handles of created and
+        // destroyed slots, the changed signatures and the free list ends
+        struct Delta
         {
-            // Initialize the queue with all possible entity IDs
-            for (Entity entity = 0; entity < MAX_ENTITIES; ++entity)
+            ElementDelta<Entity> Handles;
+            ElementDelta<Signature> Signatures;
+            unsigned FreeHead = 0;
+            unsigned FreeTail = 0;
+            unsigned LivingEntityCount = 0;
+
+            size_t GetMemoryUsage() const
             {
-                m_AvailableEntities.push(entity);
+                return Handles.GetMemoryUsage() + Signatures.GetMemoryUsage();
             }
+        };
+
+        explicit EntityManager(unsigned initialCapacity = 0)
+        {
+            Reserve(initialCapacity);
         }
 
         Entity CreateEntity()
         {
-            HZ_CORE_ASSERT(m_LivingEntityCount < MAX_ENTITIES, "Too many entities in existence.");
-
-            // Take an ID from the front of the queue
-            Entity id = m_AvailableEntities.front();
-            m_AvailableEntities.pop();
+            unsigned index;
+            if (m_FreeHead != FREE_LIST_END)
+            {
+                // Recycle the oldest free slot, its generation was bumped when it was freed
+                index = m_FreeHead;
+                const Entity freeHandle = m_Handles[index];
+                m_FreeHead = EntityIndex(freeHandle);
+                if (m_FreeHead == FREE_LIST_END)
+                {
+                    m_FreeTail = FREE_LIST_END;
+                }
+                m_Handles.Mutable(index) = MakeEntity(index, EntityGeneration(freeHandle));
+            }
+            else
+            {
+                // No free slot - grow by one
+                index = m_Handles.Size();
+                HZ_CORE_ASSERT(index < ENTITY_INDEX_MASK, "Too many entities in existence.");
+                m_Handles.EmplaceBack(MakeEntity(index, 0));
+                m_Signatures.EmplaceBack();
+            }
             ++m_LivingEntityCount;
 
-            return id;
+            return m_Handles[index];
         }
 
         void DestroyEntity(Entity entity)
         {
-            HZ_CORE_ASSERT(entity < MAX_ENTITIES, "Entity out of range.");
+            HZ_CORE_ASSERT(IsAlive(entity), "Destroying an entity that is not alive.");
 
             // Invalidate the destroyed entity's signature
-            m_Signatures[entity].reset();
-
-            // Put the destroyed ID at the back of the queue
-            m_AvailableEntities.push(entity);
+            const unsigned index = EntityIndex(entity);
+            m_Signatures.Mutable(index).reset();
+
+            // Bump the generation so that outstanding handles go stale, skipping the provisional one,
+            // then append the slot to the free list. A free slot's handle stores the index of the
+            // next free slot instead of its own, so it never matches a live handle.
+            m_Handles.Mutable(index) = MakeEntity(FREE_LIST_END, (EntityGeneration(entity) + 1) % PROVISIONAL_GENERATION);
+            if (m_FreeTail != FREE_LIST_END)
+            {
+                m_Handles.Mutable(m_FreeTail) = MakeEntity(index, EntityGeneration(m_Handles[m_FreeTail]));
+            }
+            else
+            {
+                m_FreeHead = index;
+            }
+            m_FreeTail = index;
             --m_LivingEntityCount;
         }
 
+        // One array read: a handle is alive as long as its slot still carries the same generation
+        bool IsAlive(Entity entity) const
+        {
+            const unsigned index = EntityIndex(entity);
+            return index < m_Handles.Size() && m_Handles[index] == entity && entity != NULL_ENTITY;
+        }
+
         void SetSignature(Entity entity, Signature signature)
         {
-            HZ_CORE_ASSERT(entity < MAX_ENTITIES, "Entity out of range.");
+            HZ_CORE_ASSERT(IsAlive(entity), "Entity is not alive.");
 
             // Put this entity's signature into the array
-            m_Signatures[entity] = signature;
+            m_Signatures.Mutable(EntityIndex(entity)) = signature;
         }
 
-        Signature GetSignature(Entity entity)
+        Signature GetSignature(Entity entity) const
         {
-            HZ_CORE_ASSERT(entity < MAX_ENTITIES, "Entity out of range.");
+            HZ_CORE_ASSERT(IsAlive(entity), "Entity is not alive.");
 
             // Get this entity's signature from the array
-            return m_Signatures[entity];
+            return m_Signatures[EntityIndex(entity)];
         }
 
-    private:
-        // Queue of unused entity IDs
-        std::queue<Entity> m_AvailableEntities;
-
-        // Array of signatures where the index corresponds to the entity ID
-        std::array<Signature, MAX_ENTITIES> m_Signatures;
-
-        // Total living entities - used to keep limits on how many exist
-        unsigned m_LivingEntityCount = 0;
-    };
-
-    class IComponentArray
-    {
-    public:
-        virtual ~IComponentArray() = default;
-        virtual void EntityDestroyed(Entity entity) = 0;
-
-        virtual Ref<IComponentArray> Clone() const = 0;
-    };
-
-
-    template <typename T>
-    class ComponentArray : public IComponentArray
-    {
-    public:
-
-        Ref<IComponentArray> Clone() const override
+        void Reserve(unsigned capacity)
         {
-            return std::static_pointer_cast<IComponentArray>(std::make_shared<ComponentArray<T>>(*this));
+            m_Handles.Reserve(capacity);
+            m_Signatures.Reserve(capacity);
         }
 
-        void InsertData(Entity entity, T component)
+        unsigned GetLivingEntityCount() const
         {
-            HZ_CORE_ASSERT(
-                m_EntityToIndexMap.find(entity) == m_EntityToIndexMap.end(),
-                "Component added to same entity more than once.");
-
-            // Put new entry at end and update the maps
-            unsigned long long newIndex = m_Size;
-            m_EntityToIndexMap[entity] = newIndex;
-            m_IndexToEntityMap[newIndex] = entity;
-            m_ComponentArray[newIndex] = component;
-            ++m_Size;
+            return m_LivingEntityCount;
         }
 
-        void RemoveData(Entity entity)
+        // Replaces every slot, used to load worlds. A slot is alive if its handle carries its own
+        // index, free slots are linked from freeHead to freeTail through their handles.
+        void Load(PagedVector<Entity, PAGE_SIZE> handles, PagedVector<Signature, PAGE_SIZE> signatures,
+                  unsigned freeHead, unsigned freeTail, unsigned livingEntityCount)
         {
-            HZ_CORE_ASSERT(m_EntityToIndexMap.find(entity) != m_EntityToIndexMap.end(),
-                           "Removing non-existent component.");
+            HZ_CORE_ASSERT(handles.Size() == signatures.Size(), "Handle and signature counts differ.");
+            m_Handles = std::move(handles);
+            m_Signatures = std::move(signatures);
+            m_FreeHead = freeHead;
+            m_FreeTail = freeTail;
+            m_LivingEntityCount = livingEntityCount;
+        }
 
-            // Copy element at end into deleted element's place to maintain density
-            unsigned long long indexOfRemovedEntity = m_EntityToIndexMap[entity];
-            unsigned long long indexOfLastElement = m_Size - 1;
-            m_ComponentArray[indexOfRemovedEntity] = m_ComponentArray[indexOfLastElement];
+        // Number of slots ever allocated, alive or free
+        unsigned GetSlotCount() const
+        {
+            return m_Handles.Size();
+        }
 
-            // Update map to point to moved spot
-            Entity entityOfLastElement = m_IndexToEntityMap[indexOfLastElement];
-            m_EntityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
-            m_IndexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+        const PagedVector<Entity, PAGE_SIZE>& Handles() const
+        {
+            return m_Handles;
+        }
 
-            m_EntityToIndexMap.erase(entity);
-            m_IndexToEntityMap.erase(indexOfLastElement);
+        const PagedVector<Signature, PAGE_SIZE>& Signatures() const
+        {
+            return m_Signatures;
+        }
 
-            --m_Size;
+        unsigned GetFreeHead() const
+        {
+            return m_FreeHead;
         }
 
-        T& GetData(Entity entity)
+        unsigned GetFreeTail() const
         {
-            HZ_CORE_ASSERT(m_EntityToIndexMap.find(entity) != m_EntityToIndexMap.end(),
-                           "Retrieving non-existent component.");
+            return m_FreeTail;
+        }
 
-            // Return a reference to the entity's component
-            return m_ComponentArray[m_EntityToIndexMap[entity]];
+        // Records what Revert() needs to turn this manager back into older
+        Delta Diff(const EntityManager& older) const
+        {
+            return {m_Handles.Diff(older.m_Handles), m_Signatures.Diff(older.m_Signatures),
+                    older.m_FreeHead, older.m_FreeTail, older.m_LivingEntityCount};
         }
 
-        void EntityDestroyed(Entity entity) override
+        void Revert(const Delta& delta)
         {
-            if (m_EntityToIndexMap.find(entity) != m_EntityToIndexMap.end())
-            {
-                // Remove the entity's component if it existed
-                RemoveData(entity);
-            }
+            m_Handles.Revert(delta.Handles);
+            m_Signatures.Revert(delta.Signatures);
+            m_FreeHead = delta.FreeHead;
+            m_FreeTail = delta.FreeTail;
+            m_LivingEntityCount = delta.LivingEntityCount;
         }
 
     private:
-        // The packed array of components (of generic type T),
-        // set to a specified maximum amount, matching the maximum number
-        // of entities allowed to exist simultaneously, so that each entity
-        // has a unique spot.
-        std::array<T, MAX_ENTITIES> m_ComponentArray;
+        // Slot index that terminates the free list, never a valid entity index
+        static constexpr unsigned FREE_LIST_END = ENTITY_INDEX_MASK;
 
-        // Map from an entity ID to an array index.
-        std::unordered_map<Entity, unsigned long long> m_EntityToIndexMap;
+        // FIFO of freed slots threaded through their handles, oldest first
+        unsigned m_FreeHead = FREE_LIST_END;
+        unsigned m_FreeTail = FREE_LIST_END;
 
-        // Map from an array index to an entity ID.
-        std::unordered_map<unsigned long long, Entity> m_IndexToEntityMap;
+        // Current handle of every slot ever allocated, the index corresponds to the entity index.
+        // Paged, so that snapshots share the slots nobody touched since.
+        PagedVector<Entity, PAGE_SIZE> m_Handles;
 
-        // Total size of valid entries in the array.
-        unsigned long long m_Size{};
+        // Array of signatures where the index corresponds to the entity index
+        PagedVector<Signature, PAGE_SIZE> m_Signatures;
+
+        // Total living entities
+        unsigned m_LivingEntityCount = 0;
     };
 
     class ComponentManager
     {
     public:
+        // Per component type delta of the registered pools, see Diff()
+        struct Delta
+        {
+            std::vector<Scope<IComponentArray::Delta>> Pools;
+
+            size_t GetMemoryUsage() const
+            {
+                size_t usage = Pools.capacity() * sizeof(Pools[0]);
+                for (const auto& pool : Pools)
+                {
+                    usage += pool ? pool->GetMemoryUsage() : 0;
+                }
+                return usage;
+            }
+        };
+
         ComponentManager()
         {
+            RegisterComponent<Disabled>();
         }
 
-        ComponentManager(const ComponentManager& other) : m_ComponentTypes(other.m_ComponentTypes),
-                                                          m_ComponentArrays(other.m_ComponentArrays),
-                                                          m_NextComponentType(other.m_NextComponentType)
+        ComponentManager(const ComponentManager& other)
+            : m_ComponentArrays(other.m_ComponentArrays), m_Groups(other.m_Groups), m_ChangeTick(other.m_ChangeTick)
         {
-            for (auto& [typeName, compArr] : m_ComponentArrays)
+            for (auto& compArr : m_ComponentArrays)
             {
-                compArr = compArr->Clone();
+                if (compArr)
+                {
+                    compArr = compArr->Clone();
+                    compArr->BindChangeTick(&m_ChangeTick);
+                }
             }
         }
 
-        ComponentManager(ComponentManager&& other) noexcept : m_ComponentTypes(std::move(other.m_ComponentTypes)),
-                                                              m_ComponentArrays(std::move(other.m_ComponentArrays)),
-                                                              m_NextComponentType(other.m_NextComponentType)
+        ComponentManager(ComponentManager&& other) noexcept
+            : m_ComponentArrays(std::move(other.m_ComponentArrays)), m_Groups(std::move(other.m_Groups)),
+              m_ChangeTick(other.m_ChangeTick)
         {
+            BindChangeTick();
         }
 
         ComponentManager& operator=(const ComponentManager& other)
         {
             if (this == &other)
                 return *this;
-            m_ComponentTypes = other.m_ComponentTypes;
             m_ComponentArrays = other.m_ComponentArrays;
-            m_NextComponentType = other.m_NextComponentType;
-            for (auto& [typeName, compArr] : m_ComponentArrays)
+            m_Groups = other.m_Groups;
+            m_ChangeTick = other.m_ChangeTick;
+            for (auto& compArr : m_ComponentArrays)
             {
-                compArr = compArr->Clone();
+                if (compArr)
+                {
+                    compArr = compArr->Clone();
+                    compArr->BindChangeTick(&m_ChangeTick);
+                }
             }
             return *this;
         }
@@ -214,47 +281,72 @@ namespace Hazel
         {
             if (this == &other)
                 return *this;
-            m_ComponentTypes = std::move(other.m_ComponentTypes);
             m_ComponentArrays = std::move(other.m_ComponentArrays);
-            m_NextComponentType = other.m_NextComponentType;
+            m_Groups = std::move(other.m_Groups);
+            m_ChangeTick = other.m_ChangeTick;
+            BindChangeTick();
             return *this;
         }
 
         template <typename T>
-        void RegisterComponent()
+        void RegisterComponent(unsigned initialCapacity = 0)
         {
-            const char* typeName = typeid(T).name();
+            const ComponentType type = ComponentTypeOf<T>();
+
+            HZ_CORE_ASSERT(type < MAX_COMPONENTS, "Too many component types.");
+            if (type >= m_ComponentArrays.size())
+            {
+                m_ComponentArrays.resize(type + 1);
+            }
 
-            HZ_CORE_ASSERT(m_ComponentTypes.find(typeName) == m_ComponentTypes.end(),
-                           "Registering component type more than once.");
+            HZ_CORE_ASSERT(!m_ComponentArrays[type], "Registering component type more than once.");
+
+            // Create a ComponentArray pointer in the slot of this component type
+            m_ComponentArrays[type] = CreateRef<ComponentArray<T>>(initialCapacity);
+            m_ComponentArrays[type]->BindChangeTick(&m_ChangeTick);
+        }
 
-            // Add this component type to the component type map
-            m_ComponentTypes.insert({typeName, m_NextComponentType});
+        template <typename T>
+        void EnableChangeTracking()
+        {
+            GetComponentArray<T>()->EnableChangeTracking();
+        }
 
-            // Create a ComponentArray pointer and add it to the component arrays map
-            m_ComponentArrays.insert({typeName, CreateRef<ComponentArray<T>>()});
+        ChangeTick GetChangeTick() const
+        {
+            return m_ChangeTick;
+        }
 
-            // Increment the value so that the next component registered will be different
-            ++m_NextComponentType;
+        // Later additions and writes are stamped with the returned tick. Must not be called while
+        // other threads write components.
+        ChangeTick AdvanceChangeTick()
+        {
+            return ++m_ChangeTick;
         }
 
         template <typename T>
-        ComponentType GetComponentType()
+        ComponentType GetComponentType() const
         {
-            const char* typeName = typeid(T).name();
+            const ComponentType type = ComponentTypeOf<T>();
 
-            HZ_CORE_ASSERT(m_ComponentTypes.find(typeName) != m_ComponentTypes.end(),
-                           "Component not registered before use.");
+            HZ_CORE_ASSERT(IsRegistered(type), "Component not registered before use.");
 
             // Return this component's type - used for creating signatures
-            return m_ComponentTypes[typeName];
+            return type;
         }
 
+        // enabled is false if the entity is disabled
         template <typename T>
-        void AddComponent(Entity entity, T component)
+        void AddComponent(Entity entity, T component, bool enabled = true)
         {
             // Add a component to the array for an entity
-            GetComponentArray<T>()->InsertData(entity, component);
+            GetComponentArray<T>()->InsertData(entity, std::move(component), enabled);
+        }
+
+        template <typename T, typename... Args>
+        void EmplaceComponent(Entity entity, bool enabled, Args&&... args)
+        {
+            GetComponentArray<T>()->EmplaceData(entity, enabled, std::forward<Args>(args)...);
         }
 
         template <typename T>
@@ -265,351 +357,1202 @@ namespace Hazel
         }
 
         template <typename T>
-        T& GetComponent(Entity entity)
+        void ReplaceComponent(Entity entity, T component)
         {
-            // Get a reference to a component from the array for an entity
-            return GetComponentArray<T>()->GetData(entity);
+            GetComponentArray<T>()->ReplaceData(entity, std::move(component));
         }
 
-        void EntityDestroyed(Entity entity)
+        // GetComponent<const T> reads without cloning a page shared with a snapshot
+        template <typename T>
+        ComponentReference<T> GetComponent(Entity entity)
         {
-            // Notify each component array that an entity has been destroyed
-            // If it has a component for that entity, it will remove it
-            for (auto const& pair : m_ComponentArrays)
+            // Get a reference to a component from the array for an entity
+            if constexpr (std::is_const_v<T>)
             {
-                auto const& component = pair.second;
-
-                component->EntityDestroyed(entity);
+                return std::as_const(*GetComponentArray<std::remove_const_t<T>>()).GetData(entity);
+            }
+            else
+            {
+                return GetComponentArray<T>()->GetData(entity);
             }
         }
 
-    private:
-        // Map from type string pointer to a component type
-        std::unordered_map<const char*, ComponentType> m_ComponentTypes;
+        void EntityDestroyed(Entity entity, Signature entitySignature)
+        {
+            LeaveGroups(entity, entitySignature, Signature{});
 
-        // Map from type string pointer to a component array
-        std::unordered_map<const char*, Ref<IComponentArray>> m_ComponentArrays;
+            // Notify the component arrays the entity has a component in that it has been destroyed
+            for (ComponentType type = 0; type < m_ComponentArrays.size(); ++type)
+            {
+                if (entitySignature.test(type))
+                {
+                    m_ComponentArrays[type]->EntityDestroyed(entity);
+                }
+            }
+        }
 
-        // The component type to be assigned to the next registered component - starting at 0
-        ComponentType m_NextComponentType{};
+        // Moves the entity's components to the enabled or the disabled part of their pools
+        void SetEntityEnabled(Entity entity, Signature entitySignature, bool enabled)
+        {
+            for (ComponentType type = 0; type < m_ComponentArrays.size(); ++type)
+            {
+                if (entitySignature.test(type))
+                {
+                    m_ComponentArrays[type]->SetEntityEnabled(entity, enabled);
+                }
+            }
+        }
 
-        // Convenience function to get the statically casted pointer to the ComponentArray of type T.
-        template <typename T>
-        Ref<ComponentArray<T>> GetComponentArray()
+        // Declares an owning group of the given component types, which must not be owned by another
+        // group yet. Entities join it through JoinGroups and GroupLivingEntities.
+        void RegisterGroup(Signature owned)
         {
-            const char* typeName = typeid(T).name();
+            HZ_CORE_ASSERT(owned.count() > 1, "A group owns at least two component types.");
+            for (const Signature& group : m_Groups)
+            {
+                HZ_CORE_ASSERT(group != owned, "Registering group more than once.");
+                HZ_CORE_ASSERT((group & owned).none(), "Component type owned by two groups.");
+            }
+            for (ComponentType type = 0; type < MAX_COMPONENTS; ++type)
+            {
+                HZ_CORE_ASSERT(!owned.test(type) || IsRegistered(type), "Component not registered before use.");
+            }
+            m_Groups.push_back(owned);
+        }
 
-            HZ_CORE_ASSERT(m_ComponentTypes.find(typeName) != m_ComponentTypes.end(),
-                           "Component not registered before use.");
+        bool IsGroupRegistered(Signature owned) const
+        {
+            return std::find(m_Groups.begin(), m_Groups.end(), owned) != m_Groups.end();
+        }
 
-            return std::static_pointer_cast<ComponentArray<T>>(m_ComponentArrays[typeName]);
+        // Takes the entity out of the groups it stops qualifying for, before any of its pools
+        // change: the group prefix of a pool only ever holds complete members
+        void LeaveGroups(Entity entity, Signature oldSignature, Signature newSignature)
+        {
+            for (const Signature& owned : m_Groups)
+            {
+                if (QualifiesForGroup(oldSignature, owned) && !QualifiesForGroup(newSignature, owned))
+                {
+                    SetEntityGrouped(entity, owned, false);
+                }
+            }
         }
-    };
 
-    class SystemManager
-    {
-    public:
-        SystemManager()
+        // Puts the entity into the groups it started qualifying for, after its pools changed
+        void JoinGroups(Entity entity, Signature oldSignature, Signature newSignature)
         {
+            for (const Signature& owned : m_Groups)
+            {
+                if (!QualifiesForGroup(oldSignature, owned) && QualifiesForGroup(newSignature, owned))
+                {
+                    SetEntityGrouped(entity, owned, true);
+                }
+            }
         }
 
-        SystemManager(const SystemManager& other) : m_Signatures(other.m_Signatures),
-                                                    m_Systems(other.m_Systems)
+        // Puts every entity into the groups it qualifies for, after a group was registered or a
+        // world was loaded
+        void GroupLivingEntities(const EntityManager& entities)
         {
-            // deep copy
-            for (auto& [typeName, systemRef] : m_Systems)
+            for (const Signature& owned : m_Groups)
             {
-                systemRef = systemRef->Clone();
+                // In the packed order of one of the pools: members found at index i move to the
+                // group size, which is at most i, so every entry is visited once. Pools that were
+                // saved grouped already start with the members and nothing moves.
+                ComponentType first = 0;
+                while (!owned.test(first))
+                {
+                    ++first;
+                }
+                const EntitySet& candidates = m_ComponentArrays[first]->Entities();
+                for (unsigned i = 0; i < candidates.Size(); ++i)
+                {
+                    const Entity entity = candidates[i];
+                    if (QualifiesForGroup(entities.GetSignature(entity), owned))
+                    {
+                        SetEntityGrouped(entity, owned, true);
+                    }
+                }
             }
         }
 
-        SystemManager(SystemManager&& other) noexcept : m_Signatures(std::move(other.m_Signatures)),
-                                                        m_Systems(std::move(other.m_Systems))
+        // Reorders the enabled entries of T's pool. sortRange(begin, count, order) fills order with
+        // the new arrangement of the entries [begin, begin + count) as for IComponentArray::Permute
+        // and returns whether it differs from the current one. If T is owned by a group, its
+        // members are sorted among themselves and the other owned pools follow in lockstep, then
+        // the enabled entities outside the group. Disabled entries keep their order.
+        template <typename T, typename SortRange>
+        void SortPool(SortRange sortRange)
         {
+            ComponentArray<T>* pool = GetComponentArray<T>();
+            const Signature owned = OwningGroup(ComponentTypeOf<T>());
+            std::vector<unsigned> order;
+
+            const unsigned groupSize = pool->GroupSize();
+            if (groupSize > 1 && sortRange(0u, groupSize, order))
+            {
+                for (ComponentType type = 0; type < m_ComponentArrays.size(); ++type)
+                {
+                    if (owned.test(type))
+                    {
+                        m_ComponentArrays[type]->Permute(0, order);
+                    }
+                }
+            }
+
+            const unsigned ungrouped = pool->ActiveSize() - groupSize;
+            if (ungrouped > 1 && sortRange(groupSize, ungrouped, order))
+            {
+                pool->Permute(groupSize, order);
+            }
         }
 
-        SystemManager& operator=(const SystemManager& other)
+        void ShrinkToFit()
         {
-            if (this == &other)
-                return *this;
-            m_Signatures = other.m_Signatures;
-            m_Systems = other.m_Systems;
-            // deep copy
-            for (auto& [typeName, systemRef] : m_Systems)
+            for (auto const& component : m_ComponentArrays)
             {
-                systemRef = systemRef->Clone();
+                if (component)
+                {
+                    component->ShrinkToFit();
+                }
             }
-            return *this;
         }
 
-        SystemManager& operator=(SystemManager&& other) noexcept
+        // Whether both managers have the same component types and groups registered
+        bool HasSameLayout(const ComponentManager& other) const
         {
-            if (this == &other)
-                return *this;
-            m_Signatures = std::move(other.m_Signatures);
-            m_Systems = std::move(other.m_Systems);
-            return *this;
+            if (m_Groups != other.m_Groups)
+            {
+                return false;
+            }
+
+            const size_t count = std::max(m_ComponentArrays.size(), other.m_ComponentArrays.size());
+            for (ComponentType type = 0; type < count; ++type)
+            {
+                if (IsRegistered(type) != other.IsRegistered(type))
+                {
+                    return false;
+                }
+            }
+            return true;
         }
 
-        template <typename T>
-        Ref<T> RegisterSystem(ECS* ecs)
+        // Records what Revert() needs to turn this manager back into older, which must have the same layout
+        Delta Diff(const ComponentManager& older) const
         {
-            const char* typeName = typeid(T).name();
+            HZ_CORE_ASSERT(HasSameLayout(older), "Diffing component managers with different registered types.");
 
-            HZ_CORE_ASSERT(m_Systems.find(typeName) == m_Systems.end(), "Registering system more than once.");
+            Delta delta;
+            delta.Pools.resize(m_ComponentArrays.size());
+            for (ComponentType type = 0; type < m_ComponentArrays.size(); ++type)
+            {
+                if (m_ComponentArrays[type])
+                {
+                    delta.Pools[type] = m_ComponentArrays[type]->Diff(*older.m_ComponentArrays[type]);
+                }
+            }
+            return delta;
+        }
 
-            // Create a pointer to the system and return it so it can be used externally
-            auto system = CreateRef<T>(ecs);
-            m_Systems.insert({typeName, system});
-            return system;
+        void Revert(const Delta& delta)
+        {
+            for (ComponentType type = 0; type < delta.Pools.size(); ++type)
+            {
+                if (delta.Pools[type])
+                {
+                    m_ComponentArrays[type]->Revert(*delta.Pools[type]);
+                }
+            }
         }
 
+        // Convenience function to get the statically casted pointer to the ComponentArray of type T.
         template <typename T>
-        void DeregisterSystem()
+        ComponentArray<T>* GetComponentArray()
         {
-            const char* typeName = typeid(T).name();
+            const ComponentType type = ComponentTypeOf<T>();
 
-            HZ_CORE_ASSERT(m_Systems.find(typeName) != m_Systems.end(), "System does not exist.");
-            m_Systems.erase(typeName);
+            HZ_CORE_ASSERT(IsRegistered(type), "Component not registered before use.");
+
+            return static_cast<ComponentArray<T>*>(m_ComponentArrays[type].get());
         }
 
         template <typename T>
-        void SetSignature(Signature signature)
+        const ComponentArray<T>* GetComponentArray() const
         {
-            const char* typeName = typeid(T).name();
+            const ComponentType type = ComponentTypeOf<T>();
 
-            HZ_CORE_ASSERT(m_Systems.find(typeName) != m_Systems.end(), "System used before registered.");
+            HZ_CORE_ASSERT(IsRegistered(type), "Component not registered before use.");
 
-            // Set the signature for this system
-            m_Signatures.insert({typeName, signature});
+            return static_cast<const ComponentArray<T>*>(m_ComponentArrays[type].get());
         }
 
-        void EntityDestroyed(Entity entity)
+        bool IsRegistered(ComponentType type) const
         {
-            // Erase a destroyed entity from all system lists
-            // mEntities is a set so no check needed
-            for (auto const& pair : m_Systems)
-            {
-                auto const& system = pair.second;
-
-                system->m_Entities.erase(entity);
-            }
+            return type < m_ComponentArrays.size() && m_ComponentArrays[type];
         }
 
-        void EntitySignatureChanged(Entity entity, Signature entitySignature)
+        // Removes every component of every type without notifying the systems
+        void Clear()
         {
-            // Notify each system that an entity's signature changed
-            for (auto const& pair : m_Systems)
+            for (auto const& component : m_ComponentArrays)
             {
-                auto const& type = pair.first;
-                auto const& system = pair.second;
-                auto const& systemSignature = m_Signatures[type];
-
-                // Entity signature matches system signature - insert into set
-                if ((entitySignature & systemSignature) == systemSignature)
-                {
-                    system->m_Entities.insert(entity);
-                    // notify the system about the change
-                    system->OnEntityAdded(entity);
-                }
-                    // Entity signature does not match system signature - erase from set
-                else
+                if (component)
                 {
-                    system->m_Entities.erase(entity);
-                    // notify the system about the change
-                    system->OnEntityRemoved(entity);
+                    component->Clear();
                 }
             }
         }
 
-        template <typename T>
-        Ref<T> GetSystem()
+    private:
+        // Disabled entities never belong to a group
+        static bool QualifiesForGroup(Signature signature, Signature owned)
         {
-            const char* typeName = typeid(T).name();
-            return std::static_pointer_cast<T>(m_Systems[typeName]);
+            return (signature & owned) == owned && !signature.test(ComponentTypeOf<Disabled>());
         }
 
-        void OnUpdate(Timestep ts)
+        // The types owned together with the given one, none if no group owns it
+        Signature OwningGroup(ComponentType type) const
         {
-            for (auto [id, system] : m_Systems)
+            for (const Signature& owned : m_Groups)
             {
-                system->OnUpdate(ts);
+                if (owned.test(type))
+                {
+                    return owned;
+                }
             }
+            return Signature();
         }
 
-        void OnEvent(Event& event)
+        void SetEntityGrouped(Entity entity, Signature owned, bool grouped)
         {
-            for (auto [id, system] : m_Systems) {
-                system->OnEvent(event);
+            for (ComponentType type = 0; type < m_ComponentArrays.size(); ++type)
+            {
+                if (owned.test(type))
+                {
+                    m_ComponentArrays[type]->SetEntityGrouped(entity, grouped);
+                }
             }
         }
 
-    private:
-        // Map from system type string pointer to a signature
-        std::unordered_map<const char*, Signature> m_Signatures;
+        // Points the pools at the tick of this manager, after it was copied or moved
+        void BindChangeTick()
+        {
+            for (auto const& component : m_ComponentArrays)
+            {
+                if (component)
+                {
+                    component->BindChangeTick(&m_ChangeTick);
+                }
+            }
+        }
+
+        // Component arrays indexed by component type, empty for types not registered with this manager
+        std::vector<Ref<IComponentArray>> m_ComponentArrays;
+
+        // Component types owned by each group in registration order, no type is owned twice
+        std::vector<Signature> m_Groups;
 
-        // Map from system type string pointer to a system pointer
-        std::unordered_map<const char*, Ref<System>> m_Systems;
+        // Starts above zero, so that a system that never ran sees every tracked component as new
+        ChangeTick m_ChangeTick = 1;
     };
 
-    class ECS
+    class SystemManager
     {
     public:
-        ECS()
+        // Per system type delta of the entity memberships, see Diff()
+        struct Delta
         {
-        }
+            std::vector<EntitySet::Delta> Entities;
 
-        ECS CreateSnapshot()
+            size_t GetMemoryUsage() const
+            {
+                size_t usage = Entities.capacity() * sizeof(EntitySet::Delta);
+                for (const auto& entities : Entities)
+                {
+                    usage += entities.GetMemoryUsage();
+                }
+                return usage;
+            }
+        };
+
+        SystemManager()
         {
-            return ECS(*this);
         }
 
-        Entity CreateEntity()
+        SystemManager(const SystemManager& other)
         {
-            return m_EntityManager.CreateEntity();
+            *this = other;
         }
 
-        // ---------------------------------------------------------------------------------------------
-        // ---------------------------------------------------------------------------------------------
+        SystemManager(SystemManager&& other) noexcept = default;
 
-        // creating quads
-        // normal quads
-        Entity CreateQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
+        SystemManager& operator=(const SystemManager& other)
         {
-            Entity e = CreateEntity();
-            AddComponent<Transform>(e, {{position.x, position.y, 0.0f}, size, 0.0f});
-            AddComponent<Colored>(e, {color});
-            AddComponent<Drawable>(e, {PrimitiveGeometryType::Quad});
-            return e;
+            if (this == &other)
+                return *this;
+            m_Signatures = other.m_Signatures;
+            m_Access = other.m_Access;
+            m_Names = other.m_Names;
+            m_Systems = other.m_Systems;
+            m_Order = other.m_Order;
+            m_SystemsByComponent = other.m_SystemsByComponent;
+            m_UnfilteredSystems = other.m_UnfilteredSystems;
+            m_Stages = other.m_Stages;
+            m_ScheduleDirty = other.m_ScheduleDirty;
+            m_SerialExecution = other.m_SerialExecution;
+            m_Epoch = other.m_Epoch;
+            // deep copy, the copies rebuild what they derived from the world before their first update
+            for (auto& systemRef : m_Systems)
+            {
+                if (systemRef)
+                {
+                    systemRef = systemRef->Clone();
+                    systemRef->m_Epoch = 0;
+                }
+            }
+            return *this;
         }
 
-        Entity CreateQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color)
+        SystemManager& operator=(SystemManager&& other) noexcept = default;
+
+        // Tells every system through OnWorldReset(), before its next update, that the world was
+        // replaced without notifying it of the entities it gained or lost
+        void ResetWorld()
         {
-            Entity e = CreateEntity();
-            AddComponent<Transform>(e, {position, size, 0.0f});
-            AddComponent<Colored>(e, {color});
-            AddComponent<Drawable>(e, {PrimitiveGeometryType::Quad});
-            return e;
+            ++m_Epoch;
         }
 
-        Entity CreateQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& texture,
-                          float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f))
+        // Points the systems at the ECS that owns this manager, after it was copied
+        void Rebind(ECS* ecs)
         {
-            Entity e = CreateEntity();
-            AddComponent<Transform>(e, {{position.x, position.y, 0.0f}, size, 0.0f});
-            AddComponent<Colored>(e, {tintColor});
-            AddComponent<Drawable>(e, {PrimitiveGeometryType::Quad});
-            AddComponent<Textured>(e, {texture, tilingFactor});
-            return e;
+            for (auto& system : m_Systems)
+            {
+                if (system)
+                {
+                    system->m_ECS = ecs;
+                }
+            }
         }
 
-        Entity CreateQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture,
-                          float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f))
+        // Whether both managers have the same systems registered with the same signatures
+        bool HasSameLayout(const SystemManager& other) const
         {
-            Entity e = CreateEntity();
-            AddComponent<Transform>(e, {position, size, 0.0f});
-            AddComponent<Colored>(e, {tintColor});
-            AddComponent<Drawable>(e, {PrimitiveGeometryType::Quad});
-            AddComponent<Textured>(e, {texture, tilingFactor});
-            return e;
+            const size_t count = std::max(m_Systems.size(), other.m_Systems.size());
+            for (unsigned type = 0; type < count; ++type)
+            {
+                const bool registered = type < m_Systems.size() && m_Systems[type];
+                const bool otherRegistered = type < other.m_Systems.size() && other.m_Systems[type];
+                if (registered != otherRegistered ||
+                    (registered && m_Signatures[type] != other.m_Signatures[type]))
+                {
+                    return false;
+                }
+            }
+            return true;
         }
 
-        // rotated quads
-        Entity CreateRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation,
-                                 const glm::vec4& color)
+        // Records what Revert() needs to turn the system memberships back into those of older, which
+        // must have the same layout. The systems' own state is not part of the delta.
+        Delta Diff(const SystemManager& older) const
         {
-            Entity e = CreateEntity();
-            AddComponent<Transform>(e, {{position.x, position.y, 0.0f}, size, rotation});
-            AddComponent<Colored>(e, {color});
-            AddComponent<Drawable>(e, {PrimitiveGeometryType::Quad});
-            return e;
+            HZ_CORE_ASSERT(HasSameLayout(older), "Diffing system managers with different registered systems.");
+
+            Delta delta;
+            delta.Entities.resize(m_Systems.size());
+            for (unsigned type = 0; type < m_Systems.size(); ++type)
+            {
+                if (m_Systems[type])
+                {
+                    delta.Entities[type] = m_Systems[type]->m_Entities.Diff(older.m_Systems[type]->m_Entities);
+                }
+            }
+            return delta;
         }
 
-        Entity CreateRotatedQuad(const glm::vec3& position, const glm::vec2& size, float rotation,
-                                 const glm::vec4& color)
+        // Empties every system, calling OnEntityRemoved for its entities
+        void RemoveAllEntities()
+        {
+            for (const unsigned type : m_Order)
+            {
+                System& system = *m_Systems[type];
+                for (unsigned i = system.m_Entities.Size(); i-- > 0;)
+                {
+                    const Entity entity = system.m_Entities[i];
+                    system.m_Entities.Erase(entity);
+                    system.OnEntityRemoved(entity);
+                }
+            }
+        }
+
+        // Adds every living entity to the systems it matches, one pass per system, after a world
+        // was loaded into empty systems
+        void AddLivingEntities(const EntityManager& entities)
+        {
+            const auto& handles = entities.Handles();
+            const auto& signatures = entities.Signatures();
+            for (const unsigned type : m_Order)
+            {
+                System& system = *m_Systems[type];
+                for (unsigned slot = 0; slot < entities.GetSlotCount(); ++slot)
+                {
+                    // Live slots carry their own index, free ones link to the next free slot
+                    const Entity entity = handles[slot];
+                    if (EntityIndex(entity) == slot && Matches(signatures[slot], m_Signatures[type]) &&
+                        system.m_Entities.Insert(entity))
+                    {
+                        system.OnEntityAdded(entity);
+                    }
+                }
+            }
+        }
+
+        // Restores the memberships without calling OnEntityAdded/OnEntityRemoved
+        void Revert(const Delta& delta)
+        {
+            for (unsigned type = 0; type < delta.Entities.size(); ++type)
+            {
+                if (m_Systems[type])
+                {
+                    m_Systems[type]->m_Entities.Revert(delta.Entities[type]);
+                }
+            }
+        }
+
+        template <typename T>
+        Ref<T> RegisterSystem(ECS* ecs)
+        {
+            const unsigned type = SystemTypeOf<T>();
+            if (type >= m_Systems.size())
+            {
+                m_Systems.resize(type + 1);
+                m_Signatures.resize(type + 1);
+                m_Access.resize(type + 1);
+                m_Names.resize(type + 1);
+            }
+
+            HZ_CORE_ASSERT(!m_Systems[type], "Registering system more than once.");
+
+            // Create a pointer to the system and return it so it can be used externally
+            auto system = CreateRef<T>(ecs);
+            m_Systems[type] = system;
+            m_Access[type] = SystemAccess();
+            m_Names[type] = typeid(T).name();
+            m_Order.push_back(type);
+            m_ScheduleDirty = true;
+            RebuildComponentIndex();
+            return system;
+        }
+
+        template <typename T>
+        void DeregisterSystem()
+        {
+            const unsigned type = SystemTypeOf<T>();
+
+            HZ_CORE_ASSERT(IsRegistered(type), "System does not exist.");
+            m_Systems[type].reset();
+            m_Signatures[type].reset();
+            m_Order.erase(std::find(m_Order.begin(), m_Order.end(), type));
+            m_ScheduleDirty = true;
+            RebuildComponentIndex();
+        }
+
+        template <typename T>
+        void SetSignature(Signature signature)
+        {
+            const unsigned type = SystemTypeOf<T>();
+
+            HZ_CORE_ASSERT(IsRegistered(type), "System used before registered.");
+
+            // Set the signature for this system
+            m_Signatures[type] = signature;
+            RebuildComponentIndex();
+        }
+
+        // Declares the components a system reads and writes, letting it run alongside other systems
+        template <typename T>
+        void SetAccess(const SystemAccess& access)
+        {
+            const unsigned type = SystemTypeOf<T>();
+
+            HZ_CORE_ASSERT(IsRegistered(type), "System used before registered.");
+
+            m_Access[type] = access;
+            m_ScheduleDirty = true;
+        }
+
+        // Runs every system on the calling thread in registration order, for debugging
+        void SetSerialExecution(bool serial)
+        {
+            m_SerialExecution = serial;
+        }
+
+        bool IsSerialExecution() const
+        {
+            return m_SerialExecution;
+        }
+
+        void EntityDestroyed(Entity entity, Signature entitySignature)
+        {
+            // Losing every component takes the entity out of every system it belonged to
+            EntitySignatureChanged(entity, entitySignature, Signature{});
+        }
+
+        void EntitySignatureChanged(Entity entity, Signature oldSignature, Signature newSignature)
+        {
+            const Signature changed = oldSignature ^ newSignature;
+            if (changed.none())
+            {
+                return;
+            }
+
+            // Disabling or enabling an entity can change its membership in any system
+            if (changed.test(ComponentTypeOf<Disabled>()))
+            {
+                for (const unsigned type : m_Order)
+                {
+                    UpdateMembership(type, entity, oldSignature, newSignature);
+                }
+                return;
+            }
+
+            // Systems without a signature only care whether the entity has any component at all
+            if (oldSignature.none() != newSignature.none())
+            {
+                for (const unsigned type : m_UnfilteredSystems)
+                {
+                    UpdateMembership(type, entity, oldSignature, newSignature);
+                }
+            }
+
+            // Only systems that include a toggled component can change their match result
+            Signature visited;
+            for (unsigned component = 0; component < MAX_COMPONENTS; ++component)
+            {
+                if (!changed.test(component))
+                {
+                    continue;
+                }
+                for (const unsigned type : m_SystemsByComponent[component])
+                {
+                    // Re-test each system once, from the first toggled component it includes
+                    if ((m_Signatures[type] & visited).none())
+                    {
+                        UpdateMembership(type, entity, oldSignature, newSignature);
+                    }
+                }
+                visited.set(component);
+            }
+        }
+
+        template <typename T>
+        Ref<T> GetSystem()
+        {
+            const unsigned type = SystemTypeOf<T>();
+            return IsRegistered(type) ? std::static_pointer_cast<T>(m_Systems[type]) : nullptr;
+        }
+
+        // beginStage runs on the calling thread before every stage and returns the change tick
+        // its systems run at, syncPoint runs after every stage. No system is running during either.
+        void OnUpdate(Timestep ts, const std::function<ChangeTick()>& beginStage, const std::function<void()>& syncPoint)
+        {
+            if (m_SerialExecution)
+            {
+                for (const unsigned type : m_Order)
+                {
+                    UpdateSystem(type, ts, beginStage());
+                    syncPoint();
+                }
+                return;
+            }
+
+            if (m_ScheduleDirty)
+            {
+                BuildSchedule();
+            }
+
+            for (const auto& stage : m_Stages)
+            {
+                // Systems within a stage do not conflict, the pool takes the ones that may leave the
+                // main thread while the main thread runs the thread-affine ones, then helps the pool
+                const ChangeTick tick = beginStage();
+                std::function<void()> mainThread;
+                if (!stage.MainThread.empty())
+                {
+                    mainThread = [this, &stage, ts, tick]
+                    {
+                        for (const unsigned type : stage.MainThread)
+                        {
+                            UpdateSystem(type, ts, tick);
+                        }
+                    };
+                }
+                ThreadPool::Get().ParallelFor(static_cast<unsigned>(stage.Workers.size()), [this, &stage, ts, tick](unsigned i)
+                {
+                    UpdateSystem(stage.Workers[i], ts, tick);
+                }, mainThread);
+                syncPoint();
+            }
+        }
+
+        void OnEvent(Event& event)
+        {
+            for (const unsigned type : m_Order)
+            {
+                m_Systems[type]->OnEvent(event);
+            }
+        }
+
+    private:
+        bool IsRegistered(unsigned type) const
+        {
+            return type < m_Systems.size() && m_Systems[type];
+        }
+
+        // Entities without any component never belong to a system, disabled ones only to systems
+        // that ask for Disabled
+        static bool Matches(Signature entitySignature, Signature systemSignature)
+        {
+            const ComponentType disabled = ComponentTypeOf<Disabled>();
+            return entitySignature.any() && (entitySignature & systemSignature) == systemSignature &&
+                (!entitySignature.test(disabled) || systemSignature.test(disabled));
+        }
+
+        // During OnUpdate the system still sees the tick of its previous run, so its filters pick
+        // up what changed since then
+        void UpdateSystem(unsigned type, Timestep ts, ChangeTick tick)
+        {
+            HZ_PROFILE_SCOPE(m_Names[type]);
+            System& system = *m_Systems[type];
+            if (system.m_Epoch != m_Epoch)
+            {
+                system.OnWorldReset();
+                system.m_Epoch = m_Epoch;
+            }
+            system.OnUpdate(ts);
+            system.m_LastRunTick = tick;
+        }
+
+        // Splits the systems into stages: a system goes one stage after the latest earlier-registered
+        // system it conflicts with, so the result only depends on registration order
+        void BuildSchedule()
+        {
+            m_Stages.clear();
+            std::vector<unsigned> stageOf(m_Systems.size(), 0);
+            for (size_t i = 0; i < m_Order.size(); ++i)
+            {
+                const unsigned type = m_Order[i];
+                unsigned stage = 0;
+                for (size_t j = 0; j < i; ++j)
+                {
+                    const unsigned earlier = m_Order[j];
+                    if (m_Access[type].ConflictsWith(m_Access[earlier]))
+                    {
+                        stage = std::max(stage, stageOf[earlier] + 1);
+                    }
+                }
+                stageOf[type] = stage;
+
+                if (stage >= m_Stages.size())
+                {
+                    m_Stages.resize(stage + 1);
+                }
+                const SystemAccess& access = m_Access[type];
+                auto& target = access.MainThreadOnly || access.Exclusive ? m_Stages[stage].MainThread : m_Stages[stage].Workers;
+                target.push_back(type);
+            }
+            m_ScheduleDirty = false;
+        }
+
+        void UpdateMembership(unsigned type, Entity entity, Signature oldSignature, Signature newSignature)
+        {
+            auto const& system = m_Systems[type];
+            auto const& systemSignature = m_Signatures[type];
+
+            const bool wasMatching = Matches(oldSignature, systemSignature);
+            const bool isMatching = Matches(newSignature, systemSignature);
+            if (wasMatching == isMatching)
+            {
+                return;
+            }
+
+            // Entity signature now matches system signature - insert into set
+            if (isMatching)
+            {
+                system->m_Entities.Insert(entity);
+                // notify the system about the change
+                system->OnEntityAdded(entity);
+            }
+                // Entity signature no longer matches system signature - erase from set
+            else
+            {
+                system->m_Entities.Erase(entity);
+                // notify the system about the change
+                system->OnEntityRemoved(entity);
+            }
+        }
+
+        void RebuildComponentIndex()
+        {
+            for (auto& systems : m_SystemsByComponent)
+            {
+                systems.clear();
+            }
+            m_UnfilteredSystems.clear();
+
+            for (unsigned type = 0; type < m_Systems.size(); ++type)
+            {
+                if (!m_Systems[type])
+                {
+                    continue;
+                }
+                if (m_Signatures[type].none())
+                {
+                    m_UnfilteredSystems.push_back(type);
+                    continue;
+                }
+                for (unsigned component = 0; component < MAX_COMPONENTS; ++component)
+                {
+                    if (m_Signatures[type].test(component))
+                    {
+                        m_SystemsByComponent[component].push_back(type);
+                    }
+                }
+            }
+        }
+
+        struct Stage
+        {
+            std::vector<unsigned> Workers;
+            std::vector<unsigned> MainThread;
+        };
+
+        // Signatures indexed by system type
+        std::vector<Signature> m_Signatures;
+
+        // Declared accesses indexed by system type
+        std::vector<SystemAccess> m_Access;
+
+        // Type names indexed by system type, used to label profiling scopes
+        std::vector<const char*> m_Names;
+
+        // Systems indexed by system type, empty for types not registered with this manager
+        std::vector<Ref<System>> m_Systems;
+
+        // For every component type, the systems whose signature includes it
+        std::array<std::vector<unsigned>, MAX_COMPONENTS> m_SystemsByComponent;
+
+        // Systems with an empty signature, they match every entity that has at least one component
+        std::vector<unsigned> m_UnfilteredSystems;
+
+        // Registered system types in registration order, the order of serial execution and events
+        std::vector<unsigned> m_Order;
+
+        // Stages of mutually compatible systems, rebuilt when systems or accesses change
+        std::vector<Stage> m_Stages;
+        bool m_ScheduleDirty = true;
+        bool m_SerialExecution = false;
+
+        // Bumped by ResetWorld(), systems that last saw an older value are reset before updating
+        unsigned m_Epoch = 1;
+    };
+
+    class ECS
+    {
+    public:
+        explicit ECS(unsigned initialEntityCapacity = 0)
+            : m_EntityManager(initialEntityCapacity), m_CommandBuffer(CreateScope<EntityCommandBuffer>())
+        {
+        }
+
+        // Copies share every component, entity and membership page with the source, a page is
+        // only cloned once either side writes to it. Pending commands are not copied.
+        ECS(const ECS& other)
+            : m_ComponentManager(other.m_ComponentManager), m_EntityManager(other.m_EntityManager),
+              m_SystemManager(other.m_SystemManager), m_CommandBuffer(CreateScope<EntityCommandBuffer>())
+        {
+            m_SystemManager.Rebind(this);
+        }
+
+        ECS& operator=(const ECS& other)
+        {
+            if (this == &other)
+                return *this;
+            m_ComponentManager = other.m_ComponentManager;
+            m_EntityManager = other.m_EntityManager;
+            m_SystemManager = other.m_SystemManager;
+            m_SystemManager.Rebind(this);
+            return *this;
+        }
+
+        ECS(ECS&& other) noexcept
+            : m_ComponentManager(std::move(other.m_ComponentManager)), m_EntityManager(std::move(other.m_EntityManager)),
+              m_SystemManager(std::move(other.m_SystemManager)), m_CommandBuffer(std::move(other.m_CommandBuffer))
+        {
+            m_SystemManager.Rebind(this);
+        }
+
+        ECS& operator=(ECS&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+            m_ComponentManager = std::move(other.m_ComponentManager);
+            m_EntityManager = std::move(other.m_EntityManager);
+            m_SystemManager = std::move(other.m_SystemManager);
+            m_CommandBuffer = std::move(other.m_CommandBuffer);
+            m_SystemManager.Rebind(this);
+            return *this;
+        }
+
+        // O(pages), no component data is copied
+        ECS CreateSnapshot()
+        {
+            return ECS(*this);
+        }
+
+        // How an older state of a world differs from a newer one, see Diff()
+        struct Delta
+        {
+            ComponentManager::Delta Components;
+            EntityManager::Delta Entities;
+            SystemManager::Delta Systems;
+
+            size_t GetMemoryUsage() const
+            {
+                return Components.GetMemoryUsage() + Entities.GetMemoryUsage() + Systems.GetMemoryUsage();
+            }
+        };
+
+        // Whether the same component types and systems are registered in both worlds, which is
+        // required to diff them
+        bool HasSameLayout(const ECS& other) const
+        {
+            return m_ComponentManager.HasSameLayout(other.m_ComponentManager) &&
+                m_SystemManager.HasSameLayout(other.m_SystemManager);
+        }
+
+        // Records the changed component values, created and destroyed entities and signature and
+        // membership changes that turn this world back into older, typically an earlier snapshot
+        // of it. Only the pages written since that snapshot are compared.
+        Delta Diff(const ECS& older) const
+        {
+            return {m_ComponentManager.Diff(older.m_ComponentManager), m_EntityManager.Diff(older.m_EntityManager),
+                    m_SystemManager.Diff(older.m_SystemManager)};
+        }
+
+        // Applies a delta from Diff(). Systems are not notified of the entities this adds or removes,
+        // they are reset instead, see System::OnWorldReset().
+        void Revert(const Delta& delta)
+        {
+            m_ComponentManager.Revert(delta.Components);
+            m_EntityManager.Revert(delta.Entities);
+            m_SystemManager.Revert(delta.Systems);
+            m_SystemManager.ResetWorld();
+        }
+
+        Entity CreateEntity()
+        {
+            return m_EntityManager.CreateEntity();
+        }
+
+        // Creates an entity with all of the given components, systems see a single signature change
+        template <typename... Ts>
+        Entity CreateEntityWith(Ts... components)
         {
             Entity e = CreateEntity();
-            AddComponent<Transform>(e, {position, size, rotation});
-            AddComponent<Colored>(e, {color});
-            AddComponent<Drawable>(e, {PrimitiveGeometryType::Quad});
+            AddComponents<Ts...>(e, std::move(components)...);
             return e;
         }
 
+        // Creates count entities, each receiving a copy of the given components
+        template <typename... Ts>
+        std::vector<Entity> CreateEntities(unsigned count, const Ts&... prototypes)
+        {
+            std::vector<Entity> entities;
+            entities.reserve(count);
+
+            m_EntityManager.Reserve(m_EntityManager.GetLivingEntityCount() + count);
+            (ReserveComponents<Ts>(count), ...);
+
+            for (unsigned i = 0; i < count; ++i)
+            {
+                entities.push_back(CreateEntityWith<Ts...>(prototypes...));
+            }
+            return entities;
+        }
+
+        // ---------------------------------------------------------------------------------------------
+        // ---------------------------------------------------------------------------------------------
+
+        // creating quads
+        // normal quads
+        Entity CreateQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
+        {
+            return CreateEntityWith(
+                Transform{{position.x, position.y, 0.0f}, size, 0.0f},
+                Colored{color},
+                Drawable{PrimitiveGeometryType::Quad});
+        }
+
+        Entity CreateQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color)
+        {
+            return CreateEntityWith(
+                Transform{position, size, 0.0f},
+                Colored{color},
+                Drawable{PrimitiveGeometryType::Quad});
+        }
+
+        Entity CreateQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& texture,
+                          float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f))
+        {
+            return CreateEntityWith(
+                Transform{{position.x, position.y, 0.0f}, size, 0.0f},
+                Colored{tintColor},
+                Drawable{PrimitiveGeometryType::Quad},
+                Textured{texture, tilingFactor});
+        }
+
+        Entity CreateQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture,
+                          float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f))
+        {
+            return CreateEntityWith(
+                Transform{position, size, 0.0f},
+                Colored{tintColor},
+                Drawable{PrimitiveGeometryType::Quad},
+                Textured{texture, tilingFactor});
+        }
+
+        // rotated quads
+        Entity CreateRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation,
+                                 const glm::vec4& color)
+        {
+            return CreateEntityWith(
+                Transform{{position.x, position.y, 0.0f}, size, rotation},
+                Colored{color},
+                Drawable{PrimitiveGeometryType::Quad});
+        }
+
+        Entity CreateRotatedQuad(const glm::vec3& position, const glm::vec2& size, float rotation,
+                                 const glm::vec4& color)
+        {
+            return CreateEntityWith(
+                Transform{position, size, rotation},
+                Colored{color},
+                Drawable{PrimitiveGeometryType::Quad});
+        }
+
         Entity CreateRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation,
                                  const Ref<Texture2D>& texture, float tilingFactor = 1.0f,
                                  const glm::vec4& tintColor = glm::vec4(1.0f))
         {
-            Entity e = CreateEntity();
-            AddComponent<Transform>(e, {{position.x, position.y, 0.0f}, size, rotation});
-            AddComponent<Colored>(e, {tintColor});
-            AddComponent<Drawable>(e, {PrimitiveGeometryType::Quad});
-            AddComponent<Textured>(e, {texture, tilingFactor});
-            return e;
+            return CreateEntityWith(
+                Transform{{position.x, position.y, 0.0f}, size, rotation},
+                Colored{tintColor},
+                Drawable{PrimitiveGeometryType::Quad},
+                Textured{texture, tilingFactor});
         }
 
         Entity CreateRotatedQuad(const glm::vec3& position, const glm::vec2& size, float rotation,
                                  const Ref<Texture2D>& texture, float tilingFactor = 1.0f,
                                  const glm::vec4& tintColor = glm::vec4(1.0f))
         {
-            Entity e = CreateEntity();
-            AddComponent<Transform>(e, {position, size, rotation});
-            AddComponent<Colored>(e, {tintColor});
-            AddComponent<Drawable>(e, {PrimitiveGeometryType::Quad});
-            AddComponent<Textured>(e, {texture, tilingFactor});
-            return e;
+            return CreateEntityWith(
+                Transform{position, size, rotation},
+                Colored{tintColor},
+                Drawable{PrimitiveGeometryType::Quad},
+                Textured{texture, tilingFactor});
         }
 
         // ---------------------------------------------------------------------------------------------
         // ---------------------------------------------------------------------------------------------
 
 
+        bool IsAlive(Entity entity) const
+        {
+            return m_EntityManager.IsAlive(entity);
+        }
+
         void DestroyEntity(Entity entity)
         {
+            const Signature signature = m_EntityManager.GetSignature(entity);
+            LeaveHierarchy(entity, signature);
+
+            // Systems are notified first, while the entity's components can still be read
+            m_SystemManager.EntityDestroyed(entity, signature);
+
+            m_ComponentManager.EntityDestroyed(entity, signature);
+
             m_EntityManager.DestroyEntity(entity);
+        }
+
+        // Makes child follow parent, or a root again for NULL_ENTITY, keeping the Children of the old
+        // and the new parent up to date. Both get a WorldTransform if they have none. Returns false,
+        // leaving the hierarchy as it was, if parent is child itself or one of its descendants.
+        bool SetParent(Entity child, Entity parent)
+        {
+            HZ_CORE_ASSERT(IsAlive(child) && (parent == NULL_ENTITY || IsAlive(parent)), "Parenting a dead entity.");
+            for (Entity ancestor = parent; ancestor != NULL_ENTITY;)
+            {
+                if (ancestor == child)
+                {
+                    HZ_CORE_WARN("Entity {0} cannot be parented to itself or one of its descendants", child);
+                    return false;
+                }
+                ancestor = IsAlive(ancestor) && HasComponent<Parent>(ancestor) ? GetComponent<const Parent>(ancestor).Handle : NULL_ENTITY;
+            }
 
-            m_ComponentManager.EntityDestroyed(entity);
+            if (HasComponent<Parent>(child))
+            {
+                const Entity previous = GetComponent<const Parent>(child).Handle;
+                if (previous == parent)
+                {
+                    return true;
+                }
+                if (previous != NULL_ENTITY && IsAlive(previous) && HasComponent<Children>(previous))
+                {
+                    auto& siblings = GetComponent<Children>(previous).Handles;
+                    siblings.erase(std::remove(siblings.begin(), siblings.end(), child), siblings.end());
+                }
+                // Written rather than removed, so that the change shows up in Changed<Parent> views
+                GetComponent<Parent>(child).Handle = parent;
+            }
+            else if (parent != NULL_ENTITY)
+            {
+                AddComponent(child, Parent{parent});
+            }
 
-            m_SystemManager.EntityDestroyed(entity);
+            if (parent == NULL_ENTITY)
+            {
+                return true;
+            }
+            if (!HasComponent<Children>(parent))
+            {
+                AddComponent(parent, Children{});
+            }
+            GetComponent<Children>(parent).Handles.push_back(child);
+            for (const Entity entity : {child, parent})
+            {
+                if (!HasComponent<WorldTransform>(entity))
+                {
+                    AddComponent(entity, WorldTransform{});
+                }
+            }
+            return true;
         }
 
 
+        // Releases component pages left empty after mass destruction
+        void ShrinkToFit()
+        {
+            m_ComponentManager.ShrinkToFit();
+        }
+
         // Component methods
         template <typename T>
-        void RegisterComponent()
+        void RegisterComponent(unsigned initialCapacity = 0)
+        {
+            m_ComponentManager.RegisterComponent<T>(initialCapacity);
+        }
+
+        // Stamps additions and writes through mutable accessors of T with the current change tick,
+        // for the Changed and Added view filters
+        template <typename T>
+        void EnableChangeTracking()
+        {
+            m_ComponentManager.EnableChangeTracking<T>();
+        }
+
+        ChangeTick GetChangeTick() const
         {
-            m_ComponentManager.RegisterComponent<T>();
+            return m_ComponentManager.GetChangeTick();
         }
 
         template <typename T>
         void AddComponent(Entity entity, T component)
         {
-            m_ComponentManager.AddComponent<T>(entity, component);
+            const auto oldSignature = m_EntityManager.GetSignature(entity);
+            auto signature = oldSignature;
+            signature.set(m_ComponentManager.GetComponentType<T>(), true);
+
+            m_ComponentManager.LeaveGroups(entity, oldSignature, signature);
+            m_ComponentManager.AddComponent<T>(entity, std::move(component), !IsDisabled(oldSignature));
+            CommitSignature(entity, oldSignature, signature);
+        }
 
-            auto signature = m_EntityManager.GetSignature(entity);
+        // Constructs the component from args inside its pool rather than moving a built one there,
+        // e.g. for components that are expensive to move. Aggregates take their members in order.
+        template <typename T, typename... Args>
+        void EmplaceComponent(Entity entity, Args&&... args)
+        {
+            const auto oldSignature = m_EntityManager.GetSignature(entity);
+            auto signature = oldSignature;
             signature.set(m_ComponentManager.GetComponentType<T>(), true);
-            m_EntityManager.SetSignature(entity, signature);
 
-            m_SystemManager.EntitySignatureChanged(entity, signature);
+            m_ComponentManager.LeaveGroups(entity, oldSignature, signature);
+            m_ComponentManager.EmplaceComponent<T>(entity, !IsDisabled(oldSignature), std::forward<Args>(args)...);
+            CommitSignature(entity, oldSignature, signature);
+        }
+
+        // Adds several components and commits the resulting signature once
+        template <typename... Ts>
+        void AddComponents(Entity entity, Ts... components)
+        {
+            const auto oldSignature = m_EntityManager.GetSignature(entity);
+            auto signature = oldSignature;
+            (signature.set(m_ComponentManager.GetComponentType<Ts>(), true), ...);
+
+            m_ComponentManager.LeaveGroups(entity, oldSignature, signature);
+            const bool enabled = !IsDisabled(oldSignature);
+            (m_ComponentManager.AddComponent<Ts>(entity, std::move(components), enabled), ...);
+            CommitSignature(entity, oldSignature, signature);
         }
 
         template <typename T>
         void RemoveComponent(Entity entity)
         {
+            const auto oldSignature = m_EntityManager.GetSignature(entity);
+            auto signature = oldSignature;
+            signature.set(m_ComponentManager.GetComponentType<T>(), false);
+
+            m_ComponentManager.LeaveGroups(entity, oldSignature, signature);
             m_ComponentManager.RemoveComponent<T>(entity);
+            CommitSignature(entity, oldSignature, signature);
+        }
 
-            auto signature = m_EntityManager.GetSignature(entity);
-            signature.set(m_ComponentManager.GetComponentType<T>(), false);
-            m_EntityManager.SetSignature(entity, signature);
+        // Disabling keeps the entity and its components but hides it from views and systems, until
+        // it is enabled again. Same as adding or removing the Disabled tag.
+        void SetEnabled(Entity entity, bool enabled)
+        {
+            if (enabled && HasComponent<Disabled>(entity))
+            {
+                RemoveComponent<Disabled>(entity);
+            }
+            else if (!enabled && !HasComponent<Disabled>(entity))
+            {
+                AddComponent(entity, Disabled{});
+            }
+        }
 
-            m_SystemManager.EntitySignatureChanged(entity, signature);
+        bool IsEnabled(Entity entity) const
+        {
+            return !IsDisabled(m_EntityManager.GetSignature(entity));
         }
 
+        // A ColumnRef rather than a reference for components stored in columns, and a const
+        // reference for shared components
         template <typename T>
-        T& GetComponent(Entity entity)
+        ComponentReference<T> GetComponent(Entity entity)
         {
             return m_ComponentManager.GetComponent<T>(entity);
         }
 
+        // Overwrites the entity's component, which must exist. Shared components are changed this
+        // way, the entity then refers to the value equal to the new one.
+        template <typename T>
+        void ReplaceComponent(Entity entity, T component)
+        {
+            m_ComponentManager.ReplaceComponent<T>(entity, std::move(component));
+        }
+
         template <typename T>
         bool HasComponent(Entity entity)
         {
@@ -624,6 +1567,81 @@ namespace Hazel
             return m_ComponentManager.GetComponentType<T>();
         }
 
+        // Joins the pools of Ts, skipping entities that have any of the excluded components
+        template <typename... Ts, typename... Excludes>
+        ComponentView<Exclude<Excludes...>, Ts...> View(Exclude<Excludes...> = {})
+        {
+            return ComponentView<Exclude<Excludes...>, Ts...>(
+                m_ComponentManager.GetComponentArray<std::remove_const_t<Ts>>()...,
+                m_ComponentManager.GetComponentArray<Excludes>()...);
+        }
+
+        // Declares an owning group: the pools of Ts are kept ordered so that their first Group<Ts...>().Size()
+        // components belong to the same enabled entities, the ones having all of Ts, in the same
+        // order. Iterating the group then needs no lookups. A component type can be owned by one
+        // group only. Entities join and leave as their components come and go, in O(1) per pool.
+        template <typename... Ts>
+        void RegisterGroup()
+        {
+            m_ComponentManager.RegisterGroup(MakeSignature<Ts...>());
+            m_ComponentManager.GroupLivingEntities(m_EntityManager);
+        }
+
+        // The members of the group registered for Ts, which may be requested as const and in any order
+        template <typename... Ts>
+        ComponentGroup<Ts...> Group()
+        {
+            HZ_CORE_ASSERT(m_ComponentManager.IsGroupRegistered(MakeSignature<std::remove_const_t<Ts>...>()),
+                           "Group not registered before use.");
+            return ComponentGroup<Ts...>(m_ComponentManager.GetComponentArray<std::remove_const_t<Ts>>()...);
+        }
+
+        // Sorts the enabled components of T stably by less(a, b), which is given const components, e.g.
+        // to draw in order or to visit components sharing a texture one after another. Views and
+        // groups iterate back to front, from the last element in this order. If T is owned by a
+        // group, the group members are sorted among themselves and the other owned pools follow.
+        // Re-sorting a pool that is almost in order is close to linear. Does not count as writing
+        // the components, but moves them: systems sorting declare the sorted pools as written.
+        template <typename T, typename Less>
+        void Sort(Less less)
+        {
+            static_assert(!std::is_empty_v<T>, "Tag components have nothing to sort by.");
+            const ComponentArray<T>& pool = *m_ComponentManager.GetComponentArray<T>();
+            m_ComponentManager.SortPool<T>([&pool, &less](unsigned begin, unsigned count, std::vector<unsigned>& order)
+            {
+                return SortOrder(count, [&pool, &less, begin](unsigned first, unsigned second)
+                {
+                    return less(pool.At(begin + first), pool.At(begin + second));
+                }, order);
+            });
+        }
+
+        // Like Sort, ordered by ascending key(entity, component) or key(component), which returns a
+        // uint64_t. Computes every key once and sorts them with a radix sort.
+        template <typename T, typename Key>
+        void SortByKey(Key key)
+        {
+            static_assert(!std::is_empty_v<T>, "Tag components have nothing to sort by.");
+            const ComponentArray<T>& pool = *m_ComponentManager.GetComponentArray<T>();
+            std::vector<uint64_t> keys;
+            m_ComponentManager.SortPool<T>([&pool, &key, &keys](unsigned begin, unsigned count, std::vector<unsigned>& order)
+            {
+                keys.resize(count);
+                for (unsigned i = 0; i < count; ++i)
+                {
+                    if constexpr (std::is_invocable_v<Key&, Entity, typename ComponentArray<T>::ConstReference>)
+                    {
+                        keys[i] = key(pool.EntityAt(begin + i), pool.At(begin + i));
+                    }
+                    else
+                    {
+                        keys[i] = key(pool.At(begin + i));
+                    }
+                }
+                return SortOrderByKey(keys, order);
+            });
+        }
+
         // System methods
         template <typename T>
         Ref<T> RegisterSystem()
@@ -643,15 +1661,52 @@ namespace Hazel
             m_SystemManager.SetSignature<T>(signature);
         }
 
+        // Declares what a system reads and writes so that the scheduler can run it concurrently
+        // with systems it does not conflict with. Such systems must not make structural changes.
+        template <typename T>
+        void SetSystemAccess(Signature reads, Signature writes, bool mainThreadOnly = false)
+        {
+            m_SystemManager.SetAccess<T>({reads, writes, mainThreadOnly, false});
+        }
+
+        void SetSerialExecution(bool serial)
+        {
+            m_SystemManager.SetSerialExecution(serial);
+        }
+
+        // Signature with the bits of all given component types set
+        template <typename... Ts>
+        Signature MakeSignature()
+        {
+            Signature signature;
+            (signature.set(m_ComponentManager.GetComponentType<Ts>()), ...);
+            return signature;
+        }
+
         template <typename T>
         Ref<T> GetSystem()
         {
             return m_SystemManager.GetSystem<T>();
         }
 
+        // Structural changes made from systems go through the command buffer, it is played back
+        // after every stage of systems
+        EntityCommandBuffer& GetCommandBuffer()
+        {
+            return *m_CommandBuffer;
+        }
+
+        // Every stage runs at a fresh change tick, and so does the playback after it: stages never
+        // share a tick with changes their systems have not seen yet
         void OnUpdate(Timestep ts)
         {
-            m_SystemManager.OnUpdate(ts);
+            m_SystemManager.OnUpdate(ts,
+                [this] { return m_ComponentManager.AdvanceChangeTick(); },
+                [this]
+                {
+                    m_ComponentManager.AdvanceChangeTick();
+                    m_CommandBuffer->Playback(*this);
+                });
         }
 
         void OnEvent(Event& event)
@@ -660,8 +1715,108 @@ namespace Hazel
         }
 
     private:
+        static bool IsDisabled(Signature signature)
+        {
+            return signature.test(ComponentTypeOf<Disabled>());
+        }
+
+        // Takes a destroyed entity out of its parent's Children and makes its children roots, the
+        // way SetParent(child, NULL_ENTITY) would
+        void LeaveHierarchy(Entity entity, Signature signature)
+        {
+            const ComponentType parentType = ComponentTypeOf<Parent>();
+            if (m_ComponentManager.IsRegistered(parentType) && signature.test(parentType))
+            {
+                const Entity parent = GetComponent<const Parent>(entity).Handle;
+                if (parent != NULL_ENTITY && IsAlive(parent) && HasComponent<Children>(parent))
+                {
+                    auto& siblings = GetComponent<Children>(parent).Handles;
+                    siblings.erase(std::remove(siblings.begin(), siblings.end(), entity), siblings.end());
+                }
+            }
+
+            const ComponentType childrenType = ComponentTypeOf<Children>();
+            if (m_ComponentManager.IsRegistered(childrenType) && signature.test(childrenType))
+            {
+                for (const Entity child : GetComponent<const Children>(entity).Handles)
+                {
+                    if (IsAlive(child) && HasComponent<Parent>(child) && GetComponent<const Parent>(child).Handle == entity)
+                    {
+                        GetComponent<Parent>(child).Handle = NULL_ENTITY;
+                    }
+                }
+            }
+        }
+
+        // Stores the signature once the pools hold the entity's new components, moves them across
+        // the disabled partition if the Disabled tag came or went, completes the groups it now
+        // qualifies for and tells the systems
+        void CommitSignature(Entity entity, Signature oldSignature, Signature newSignature)
+        {
+            m_EntityManager.SetSignature(entity, newSignature);
+            if (IsDisabled(oldSignature) != IsDisabled(newSignature))
+            {
+                m_ComponentManager.SetEntityEnabled(entity, newSignature, !IsDisabled(newSignature));
+            }
+            m_ComponentManager.JoinGroups(entity, oldSignature, newSignature);
+            m_SystemManager.EntitySignatureChanged(entity, oldSignature, newSignature);
+        }
+
+        template <typename T>
+        void ReserveComponents(unsigned additional)
+        {
+            auto* componentArray = m_ComponentManager.GetComponentArray<T>();
+            componentArray->Reserve(componentArray->Size() + additional);
+        }
+
         ComponentManager m_ComponentManager;
         EntityManager m_EntityManager;
         SystemManager m_SystemManager;
+
+        // Held by pointer so that moving the world keeps the buffer that threads may have cached
+        Scope<EntityCommandBuffer> m_CommandBuffer;
+
+        friend class WorldSerializer;
     };
+
+    // EntityCommandBuffer commands, defined here as they need the complete ECS
+
+    template <typename... Ts>
+    Entity EntityCommandBuffer::ApplyCreateEntity(ECS& ecs, Entity, void* payload)
+    {
+        return std::apply([&ecs](Ts&... components)
+        {
+            return ecs.CreateEntityWith<Ts...>(std::move(components)...);
+        }, *static_cast<std::tuple<Ts...>*>(payload));
+    }
+
+    template <typename T>
+    Entity EntityCommandBuffer::ApplyAddComponent(ECS& ecs, Entity entity, void* payload)
+    {
+        if (!ecs.IsAlive(entity))
+        {
+            return NULL_ENTITY;
+        }
+
+        T& component = *static_cast<T*>(payload);
+        if (ecs.HasComponent<T>(entity))
+        {
+            ecs.ReplaceComponent<T>(entity, std::move(component));
+        }
+        else
+        {
+            ecs.AddComponent<T>(entity, std::move(component));
+        }
+        return NULL_ENTITY;
+    }
+
+    template <typename T>
+    Entity EntityCommandBuffer::ApplyRemoveComponent(ECS& ecs, Entity entity, void*)
+    {
+        if (ecs.IsAlive(entity) && ecs.HasComponent<T>(entity))
+        {
+            ecs.RemoveComponent<T>(entity);
+        }
+        return NULL_ENTITY;
+    }
 }
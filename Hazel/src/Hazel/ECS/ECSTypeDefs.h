@@ -1,14 +1,102 @@
 #pragma once
+#include <atomic>
 #include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 namespace Hazel
 {
-    using Entity = unsigned;
-    constexpr unsigned MAX_ENTITIES = 5000;
+    // An entity is a handle packing a slot index (low bits) and a generation (high bits).
+    // The generation is bumped every time a slot is recycled, so handles to destroyed
+    // entities can be told apart from the entity that reuses their slot.
+    using Entity = uint32_t;
+
+    constexpr unsigned ENTITY_INDEX_BITS = 22;
+    constexpr unsigned ENTITY_GENERATION_BITS = 32 - ENTITY_INDEX_BITS;
+    constexpr Entity ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+    constexpr Entity ENTITY_GENERATION_MASK = (1u << ENTITY_GENERATION_BITS) - 1;
+
+    // Never handed out, the slot index it encodes is reserved
+    constexpr Entity NULL_ENTITY = ~0u;
+
+    // Live entities never carry the last generation, command buffers hand out handles with it for
+    // entities they have yet to create
+    constexpr unsigned PROVISIONAL_GENERATION = ENTITY_GENERATION_MASK;
+
+    constexpr unsigned EntityIndex(Entity entity)
+    {
+        return entity & ENTITY_INDEX_MASK;
+    }
+
+    constexpr unsigned EntityGeneration(Entity entity)
+    {
+        return entity >> ENTITY_INDEX_BITS;
+    }
+
+    constexpr Entity MakeEntity(unsigned index, unsigned generation)
+    {
+        return (index & ENTITY_INDEX_MASK) | ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS);
+    }
+
+    constexpr bool IsProvisional(Entity entity)
+    {
+        return EntityGeneration(entity) == PROVISIONAL_GENERATION && entity != NULL_ENTITY;
+    }
+
+    constexpr size_t CACHE_LINE_SIZE = 64;
 
     using ComponentType = unsigned char;
     const unsigned char MAX_COMPONENTS = 32;
 
     using Signature = std::bitset<MAX_COMPONENTS>;
 
+    // Stamped on components that are added or written while change tracking is on, advanced
+    // around every stage of systems. Compared by difference, so wrapping around is harmless.
+    using ChangeTick = uint32_t;
+
+    constexpr bool IsNewerTick(ChangeTick tick, ChangeTick since)
+    {
+        return static_cast<int32_t>(tick - since) > 0;
+    }
+
+    // Hands out dense indices per family, in order of first use. Every type gets its index once,
+    // after that a lookup is a load from a function-local static.
+    template <typename Family>
+    class TypeIndex
+    {
+    public:
+        template <typename T>
+        static unsigned Get()
+        {
+            static const unsigned s_Index = s_NextIndex++;
+            return s_Index;
+        }
+
+    private:
+        inline static std::atomic<unsigned> s_NextIndex{0};
+    };
+
+    // Built-in tag, registered with every world. Views and systems skip entities that have it unless
+    // they include it themselves, and their components are kept apart from the enabled ones so
+    // that skipping them costs nothing.
+    struct Disabled
+    {
+    };
+
+    struct ComponentFamily;
+    struct SystemFamily;
+
+    // Component types are shared by all ECS instances, so a type has the same signature bit everywhere
+    template <typename T>
+    ComponentType ComponentTypeOf()
+    {
+        return static_cast<ComponentType>(TypeIndex<ComponentFamily>::Get<std::remove_cv_t<T>>());
+    }
+
+    template <typename T>
+    unsigned SystemTypeOf()
+    {
+        return TypeIndex<SystemFamily>::Get<T>();
+    }
 }
@@ -0,0 +1,150 @@
+#include "hzpch.h"
+#include "EntityCommandBuffer.h"
+
+#include "ECSCore.h"
+
+namespace Hazel
+{
+    EntityCommandBuffer::EntityCommandBuffer()
+        : m_Id(s_NextId++)
+    {
+    }
+
+    EntityCommandBuffer::~EntityCommandBuffer()
+    {
+        for (const auto& log : m_Logs)
+        {
+            for (const Command& command : log->Commands)
+            {
+                if (command.Destroy)
+                {
+                    command.Destroy(command.Payload);
+                }
+            }
+        }
+    }
+
+    void EntityCommandBuffer::Playback(ECS& ecs)
+    {
+        if (Empty())
+        {
+            return;
+        }
+
+        HZ_PROFILE_FUNCTION();
+
+        m_Merged.clear();
+        for (const auto& log : m_Logs)
+        {
+            m_Merged.insert(m_Merged.end(), log->Commands.begin(), log->Commands.end());
+        }
+
+        // Sequence and log are unique together, so the order is total
+        std::sort(m_Merged.begin(), m_Merged.end(), [](const Command& a, const Command& b)
+        {
+            return std::tie(a.SortKey, a.Sequence, a.Log) < std::tie(b.SortKey, b.Sequence, b.Log);
+        });
+
+        m_Created.assign(m_NextProvisional.load(), NULL_ENTITY);
+        m_PlayingBack = true;
+        for (const Command& command : m_Merged)
+        {
+            const Entity created = command.Apply(ecs, Resolve(command.Target), command.Payload);
+            if (created != NULL_ENTITY)
+            {
+                m_Created[EntityIndex(command.Target)] = created;
+            }
+        }
+        m_PlayingBack = false;
+        m_NextProvisional = 0;
+        m_Created.clear();
+
+        for (const Command& command : m_Merged)
+        {
+            if (command.Destroy)
+            {
+                command.Destroy(command.Payload);
+            }
+        }
+        for (const auto& log : m_Logs)
+        {
+            log->Commands.clear();
+            log->Payloads.Reset();
+        }
+        m_Merged.clear();
+    }
+
+    bool EntityCommandBuffer::Empty() const
+    {
+        return std::all_of(m_Logs.begin(), m_Logs.end(), [](const auto& log) { return log->Commands.empty(); });
+    }
+
+    EntityCommandBuffer::ThreadLog& EntityCommandBuffer::GetLog()
+    {
+        // Threads keep the log of the buffer they recorded into last, switching buffers looks it up again
+        struct CachedLog
+        {
+            uint64_t Buffer = 0;
+            ThreadLog* Log = nullptr;
+        };
+        static thread_local CachedLog t_Cache;
+        if (t_Cache.Buffer == m_Id)
+        {
+            return *t_Cache.Log;
+        }
+
+        std::lock_guard<std::mutex> lock(m_LogsMutex);
+        const std::thread::id thread = std::this_thread::get_id();
+        auto it = std::find_if(m_Logs.begin(), m_Logs.end(), [thread](const auto& log) { return log->Thread == thread; });
+        if (it == m_Logs.end())
+        {
+            auto log = std::make_unique<ThreadLog>();
+            log->Thread = thread;
+            log->Index = static_cast<uint32_t>(m_Logs.size());
+            m_Logs.push_back(std::move(log));
+            it = m_Logs.end() - 1;
+        }
+        t_Cache = {m_Id, it->get()};
+        return **it;
+    }
+
+    Entity EntityCommandBuffer::ApplyDestroyEntity(ECS& ecs, Entity entity, void*)
+    {
+        if (ecs.IsAlive(entity))
+        {
+            ecs.DestroyEntity(entity);
+        }
+        return NULL_ENTITY;
+    }
+
+    void* EntityCommandBuffer::Arena::Allocate(size_t size, size_t alignment)
+    {
+        while (true)
+        {
+            if (m_Block < m_Blocks.size())
+            {
+                Block& block = m_Blocks[m_Block];
+                void* pointer = block.Data.get() + m_Offset;
+                size_t space = block.Size - m_Offset;
+                if (std::align(alignment, size, pointer, space))
+                {
+                    m_Offset = block.Size - space + size;
+                    return pointer;
+                }
+                ++m_Block;
+                m_Offset = 0;
+                continue;
+            }
+
+            // Oversized payloads get a block of their own
+            const size_t blockSize = std::max(BLOCK_SIZE, size + alignment);
+            m_Blocks.push_back({std::make_unique<char[]>(blockSize), blockSize});
+        }
+    }
+
+    void EntityCommandBuffer::Arena::Reset()
+    {
+        m_Block = 0;
+        m_Offset = 0;
+    }
+}
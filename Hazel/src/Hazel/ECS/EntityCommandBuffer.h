@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Hazel/Core/Core.h"
+#include "ECSTypeDefs.h"
+
+namespace Hazel
+{
+    class ECS;
+
+    // Records structural changes - creating and destroying entities, adding and removing components -
+    // and applies them later, at a point where nothing iterates the world. Any thread may record:
+    // every thread appends to a log of its own whose payloads live in an arena, without locking.
+    //
+    // Playback orders the commands by sort key, then by their sequence number within the recording
+    // thread, then by thread. The order of one thread's commands with equal keys is kept whichever
+    // threads ran the other work, so parallel recorders should pass a key naming their work item,
+    // e.g. the entity being processed.
+    //
+    // Created entities get a provisional handle, which the other commands of the same buffer may
+    // target. Playback maps it to the real entity and skips commands that run before the creation.
+    // Provisional handles are numbered afresh after every playback, so they must not outlive it.
+    class EntityCommandBuffer
+    {
+    public:
+        EntityCommandBuffer();
+        ~EntityCommandBuffer();
+
+        EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+        EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+        // Creates an entity with the given components, systems see a single signature change.
+        // Returns the provisional handle of the entity, it is only valid within this buffer.
+        template <typename... Ts>
+        Entity CreateEntity(uint64_t sortKey, Ts... components)
+        {
+            const unsigned index = m_NextProvisional++;
+            HZ_CORE_ASSERT(index < ENTITY_INDEX_MASK, "Too many entities created by one playback.");
+            const Entity entity = MakeEntity(index, PROVISIONAL_GENERATION);
+            Record(sortKey, entity, &ApplyCreateEntity<Ts...>, std::tuple<Ts...>(std::move(components)...));
+            return entity;
+        }
+
+        // Skipped if the entity is no longer alive at playback
+        void DestroyEntity(uint64_t sortKey, Entity entity)
+        {
+            Record(sortKey, entity, &ApplyDestroyEntity, std::tuple<>());
+        }
+
+        // Replaces the component if the entity already has one at playback
+        template <typename T>
+        void AddComponent(uint64_t sortKey, Entity entity, T component)
+        {
+            Record(sortKey, entity, &ApplyAddComponent<T>, std::move(component));
+        }
+
+        // Skipped if the entity does not have the component at playback
+        template <typename T>
+        void RemoveComponent(uint64_t sortKey, Entity entity)
+        {
+            Record(sortKey, entity, &ApplyRemoveComponent<T>, std::tuple<>());
+        }
+
+        // Applies all recorded commands and clears the buffer. No thread may record meanwhile,
+        // including the callbacks of systems reacting to the changes.
+        void Playback(ECS& ecs);
+
+        bool Empty() const;
+
+    private:
+        // Returns the entity the command created, NULL_ENTITY if none
+        using ApplyFunc = Entity (*)(ECS& ecs, Entity entity, void* payload);
+        using DestroyFunc = void (*)(void* payload);
+
+        struct Command
+        {
+            uint64_t SortKey;
+            uint32_t Log;
+            uint32_t Sequence;
+            Entity Target;
+            ApplyFunc Apply;
+            DestroyFunc Destroy;
+            void* Payload;
+        };
+
+        // Bump allocator for command payloads, its blocks are reused after every playback
+        class Arena
+        {
+        public:
+            void* Allocate(size_t size, size_t alignment);
+            void Reset();
+
+        private:
+            static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+            struct Block
+            {
+                std::unique_ptr<char[]> Data;
+                size_t Size;
+            };
+
+            std::vector<Block> m_Blocks;
+            size_t m_Block = 0;
+            size_t m_Offset = 0;
+        };
+
+        struct ThreadLog
+        {
+            std::thread::id Thread;
+            uint32_t Index;
+            std::vector<Command> Commands;
+            Arena Payloads;
+        };
+
+        // The real entity for a provisional handle once it has been created, otherwise the handle
+        Entity Resolve(Entity entity) const
+        {
+            if (!IsProvisional(entity))
+            {
+                return entity;
+            }
+            const unsigned index = EntityIndex(entity);
+            return index < m_Created.size() ? m_Created[index] : NULL_ENTITY;
+        }
+
+        template <typename Payload>
+        void Record(uint64_t sortKey, Entity target, ApplyFunc apply, Payload payload)
+        {
+            ThreadLog& log = GetLog();
+            HZ_CORE_ASSERT(!m_PlayingBack, "Recording into a command buffer during its playback.");
+
+            void* memory = log.Payloads.Allocate(sizeof(Payload), alignof(Payload));
+            new(memory) Payload(std::move(payload));
+
+            DestroyFunc destroy = nullptr;
+            if constexpr (!std::is_trivially_destructible_v<Payload>)
+            {
+                destroy = [](void* pointer) { static_cast<Payload*>(pointer)->~Payload(); };
+            }
+            log.Commands.push_back({sortKey, log.Index, static_cast<uint32_t>(log.Commands.size()), target, apply, destroy, memory});
+        }
+
+        // The calling thread's log, registered on its first command
+        ThreadLog& GetLog();
+
+        // Defined in ECSCore.h, where ECS is complete
+        template <typename... Ts>
+        static Entity ApplyCreateEntity(ECS& ecs, Entity entity, void* payload);
+        static Entity ApplyDestroyEntity(ECS& ecs, Entity entity, void* payload);
+        template <typename T>
+        static Entity ApplyAddComponent(ECS& ecs, Entity entity, void* payload);
+        template <typename T>
+        static Entity ApplyRemoveComponent(ECS& ecs, Entity entity, void* payload);
+
+        // Logs in order of registration, never moved once created
+        std::vector<std::unique_ptr<ThreadLog>> m_Logs;
+        std::mutex m_LogsMutex;
+
+        // Identifies the buffer in the per-thread log cache, never reused
+        const uint64_t m_Id;
+        inline static std::atomic<uint64_t> s_NextId{1};
+
+        // Provisional handles recorded since the last playback, and the entities created for them
+        std::atomic<unsigned> m_NextProvisional{0};
+        std::vector<Entity> m_Created;
+
+        // Commands of all logs merged for playback, kept for its capacity
+        std::vector<Command> m_Merged;
+        bool m_PlayingBack = false;
+    };
+}
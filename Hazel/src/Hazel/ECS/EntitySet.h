@@ -0,0 +1,308 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "Hazel/Core/Core.h"
+#include "ECSTypeDefs.h"
+#include "PagedVector.h"
+
+namespace Hazel
+{
+    // Sparse set of entities: a paged sparse array indexed by entity index pointing into a packed
+    // array of handles. Insert, erase and lookup are O(1) and iteration is a linear walk. Both
+    // arrays share their pages with copies of the set until either side writes to them.
+    class EntitySet
+    {
+    public:
+        // Number of handles stored in one page of the packed array
+        static constexpr unsigned PACKED_PAGE_SIZE = 4096;
+
+        // Number of entity slots covered by one page of the sparse array
+        static constexpr unsigned SPARSE_PAGE_SIZE = 1024;
+
+        // Marks a sparse slot that does not point into the packed array
+        static constexpr unsigned INVALID_INDEX = ~0u;
+
+        using PackedArray = PagedVector<Entity, PACKED_PAGE_SIZE>;
+        using SparseArray = SparsePagedArray<unsigned, SPARSE_PAGE_SIZE>;
+
+        class Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Entity;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Entity*;
+            using reference = Entity;
+
+            Iterator(const EntitySet* set, unsigned index) : m_Set(set), m_Index(index)
+            {
+            }
+
+            Entity operator*() const
+            {
+                return (*m_Set)[m_Index];
+            }
+
+            Iterator& operator++()
+            {
+                ++m_Index;
+                return *this;
+            }
+
+            bool operator==(const Iterator& other) const
+            {
+                return m_Index == other.m_Index;
+            }
+
+            bool operator!=(const Iterator& other) const
+            {
+                return m_Index != other.m_Index;
+            }
+
+        private:
+            const EntitySet* m_Set;
+            unsigned m_Index;
+        };
+
+        // How an older version of a set differs from a newer one, see Diff()
+        struct Delta
+        {
+            ElementDelta<Entity> Packed;
+            ElementDelta<unsigned> Sparse;
+            bool SortByEntity = false;
+            bool Unsorted = false;
+
+            size_t GetMemoryUsage() const
+            {
+                return Packed.GetMemoryUsage() + Sparse.GetMemoryUsage();
+            }
+        };
+
+        EntitySet() : m_Sparse(INVALID_INDEX)
+        {
+        }
+
+        // Returns false if the entity was already in the set
+        bool Insert(Entity entity)
+        {
+            if (Contains(entity))
+            {
+                return false;
+            }
+
+            if (m_SortByEntity && !m_Packed.Empty() && entity < m_Packed[m_Packed.Size() - 1])
+            {
+                m_Unsorted = true;
+            }
+
+            // Put new entry at end and point the entity's sparse slot at it
+            m_Sparse.Mutable(EntityIndex(entity)) = m_Packed.Size();
+            m_Packed.EmplaceBack(entity);
+            return true;
+        }
+
+        // Swap-and-pop: the last entity takes over the packed index of the erased one.
+        // Returns false if the entity was not in the set.
+        bool Erase(Entity entity)
+        {
+            const unsigned index = Find(entity);
+            if (index == INVALID_INDEX)
+            {
+                return false;
+            }
+
+            const unsigned lastIndex = m_Packed.Size() - 1;
+            if (index != lastIndex)
+            {
+                const Entity last = m_Packed[lastIndex];
+                m_Packed.Mutable(index) = last;
+                m_Sparse.Mutable(EntityIndex(last)) = index;
+
+                if (m_SortByEntity)
+                {
+                    m_Unsorted = true;
+                }
+            }
+            m_Sparse.Mutable(EntityIndex(entity)) = INVALID_INDEX;
+            m_Packed.PopBack();
+            return true;
+        }
+
+        // Exchanges the entities at two packed indices
+        void Swap(unsigned first, unsigned second)
+        {
+            if (first == second)
+            {
+                return;
+            }
+
+            const Entity firstEntity = m_Packed[first];
+            const Entity secondEntity = m_Packed[second];
+            m_Packed.Mutable(first) = secondEntity;
+            m_Packed.Mutable(second) = firstEntity;
+            m_Sparse.Mutable(EntityIndex(firstEntity)) = second;
+            m_Sparse.Mutable(EntityIndex(secondEntity)) = first;
+
+            if (m_SortByEntity)
+            {
+                m_Unsorted = true;
+            }
+        }
+
+        // Packed index of the entity, or INVALID_INDEX if it is not in the set
+        unsigned Find(Entity entity) const
+        {
+            // The packed entity must match the full handle, a recycled slot does not count
+            const unsigned packedIndex = m_Sparse.Get(EntityIndex(entity));
+            return packedIndex != INVALID_INDEX && m_Packed[packedIndex] == entity ? packedIndex : INVALID_INDEX;
+        }
+
+        bool Contains(Entity entity) const
+        {
+            return Find(entity) != INVALID_INDEX;
+        }
+
+        void Clear()
+        {
+            for (unsigned i = 0; i < m_Packed.Size(); ++i)
+            {
+                m_Sparse.Mutable(EntityIndex(m_Packed[i])) = INVALID_INDEX;
+            }
+            m_Packed.Clear();
+            m_Unsorted = false;
+        }
+
+        // Sorts the packed array by ascending entity handle
+        void Sort()
+        {
+            std::vector<Entity> entities;
+            entities.reserve(m_Packed.Size());
+            for (unsigned i = 0; i < m_Packed.Size(); ++i)
+            {
+                entities.push_back(m_Packed[i]);
+            }
+            std::sort(entities.begin(), entities.end());
+            for (unsigned i = 0; i < entities.size(); ++i)
+            {
+                if (m_Packed[i] != entities[i])
+                {
+                    m_Packed.Mutable(i) = entities[i];
+                    m_Sparse.Mutable(EntityIndex(entities[i])) = i;
+                }
+            }
+            m_Unsorted = false;
+        }
+
+        // When enabled, iteration is always in ascending entity order. The set is re-sorted
+        // lazily at the start of an iteration after inserts or erases disturbed the order.
+        void SetSortByEntity(bool sortByEntity)
+        {
+            m_SortByEntity = sortByEntity;
+            m_Unsorted = false;
+            for (unsigned i = 1; sortByEntity && i < m_Packed.Size(); ++i)
+            {
+                if (m_Packed[i] < m_Packed[i - 1])
+                {
+                    m_Unsorted = true;
+                    break;
+                }
+            }
+        }
+
+        void Reserve(unsigned capacity)
+        {
+            m_Packed.Reserve(capacity);
+        }
+
+        void ShrinkToFit()
+        {
+            m_Packed.ShrinkToFit();
+            m_Sparse.ShrinkToFit();
+        }
+
+        // Replaces the contents with a packed array and the sparse array indexing it
+        void Load(PackedArray packed, SparseArray sparse)
+        {
+            m_Packed = std::move(packed);
+            m_Sparse = std::move(sparse);
+            SetSortByEntity(m_SortByEntity);
+        }
+
+        const PackedArray& Packed() const
+        {
+            return m_Packed;
+        }
+
+        const SparseArray& Sparse() const
+        {
+            return m_Sparse;
+        }
+
+        // Records what Revert() needs to turn this set back into older
+        Delta Diff(const EntitySet& older) const
+        {
+            return {m_Packed.Diff(older.m_Packed), m_Sparse.Diff(older.m_Sparse), older.m_SortByEntity, older.m_Unsorted};
+        }
+
+        void Revert(const Delta& delta)
+        {
+            m_Packed.Revert(delta.Packed);
+            m_Sparse.Revert(delta.Sparse);
+            m_SortByEntity = delta.SortByEntity;
+            m_Unsorted = delta.Unsorted;
+        }
+
+        unsigned Size() const
+        {
+            return m_Packed.Size();
+        }
+
+        bool Empty() const
+        {
+            return m_Packed.Empty();
+        }
+
+        Entity operator[](unsigned index) const
+        {
+            return m_Packed[index];
+        }
+
+        Iterator begin()
+        {
+            if (m_Unsorted)
+            {
+                Sort();
+            }
+            return Iterator(this, 0);
+        }
+
+        Iterator end()
+        {
+            return Iterator(this, Size());
+        }
+
+        Iterator begin() const
+        {
+            HZ_CORE_ASSERT(!m_Unsorted, "Iterating an unsorted set through a const reference.");
+            return Iterator(this, 0);
+        }
+
+        Iterator end() const
+        {
+            return Iterator(this, Size());
+        }
+
+    private:
+        // Packed array of the entities in the set
+        PackedArray m_Packed;
+
+        // Sparse array from an entity index to an index into m_Packed
+        SparseArray m_Sparse;
+
+        bool m_SortByEntity = false;
+        bool m_Unsorted = false;
+    };
+}
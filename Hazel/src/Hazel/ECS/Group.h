@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ComponentArray.h"
+#include "ECSTypeDefs.h"
+#include "Hazel/Core/ThreadPool.h"
+
+namespace Hazel
+{
+    // The members of an owning group, see ECS::RegisterGroup. Packed index i of every pool of the
+    // group belongs to the same entity for i < Size(), so iteration reads the pools side by side
+    // without probing any of them. Components requested as const are read through the const pools.
+    template <typename... Includes>
+    class ComponentGroup
+    {
+        static_assert(sizeof...(Includes) > 1, "A group owns at least two component types.");
+
+    public:
+        // Chunk boundaries of parallel iteration are multiples of this many members, so that two
+        // chunks never share a cache line of any pool
+        static constexpr unsigned CHUNK_GRANULARITY = static_cast<unsigned>(CACHE_LINE_SIZE);
+
+        // Members per column chunk, chunks never cross a page of any of the pools
+        static constexpr unsigned CHUNK_SIZE = std::min({ComponentArray<std::remove_const_t<Includes>>::CHUNK_SIZE...});
+
+        explicit ComponentGroup(ComponentArray<std::remove_const_t<Includes>>*... pools) : m_Pools(pools...)
+        {
+        }
+
+        // Calls func(entity, components...) or func(components...) for every member. Iterates back
+        // to front, so the current entity may safely leave the group inside func.
+        template <typename Func>
+        void Each(Func func) const
+        {
+            EachInRange(0, Size(), func);
+        }
+
+        // Like Each, but splits the members into chunks that run on the shared thread pool. func is
+        // called concurrently for different entities and must only touch their components.
+        template <typename Func>
+        void ParallelEach(Func func) const
+        {
+            const unsigned size = Size();
+            const unsigned target = size / (ThreadPool::Get().GetConcurrency() * 4) + 1;
+            const unsigned chunkSize = (target + CHUNK_GRANULARITY - 1) / CHUNK_GRANULARITY * CHUNK_GRANULARITY;
+            const unsigned chunkCount = (size + chunkSize - 1) / chunkSize;
+
+            MakeWritablePoolsUnique();
+            ThreadPool::Get().ParallelFor(chunkCount, [&](unsigned chunk)
+            {
+                const unsigned begin = chunk * chunkSize;
+                EachInRange(begin, std::min(size, begin + chunkSize), func);
+            });
+        }
+
+        // Hands the members to func(entities, components...) in runs of up to CHUNK_SIZE, as a
+        // ColumnSpan of the entities and for every component type a ColumnChunk if it is stored in
+        // columns and a ColumnSpan otherwise, all of the same length. Tags cannot be chunked. func
+        // must not make structural changes.
+        template <typename Func>
+        void EachColumnChunk(Func func) const
+        {
+            const unsigned size = Size();
+            for (unsigned begin = 0; begin < size; begin += CHUNK_SIZE)
+            {
+                FetchChunks(begin, std::min(CHUNK_SIZE, size - begin), func, std::index_sequence_for<Includes...>{});
+            }
+        }
+
+        // Like EachColumnChunk, but the chunks run on the shared thread pool
+        template <typename Func>
+        void ParallelColumnChunks(Func func) const
+        {
+            const unsigned size = Size();
+            const unsigned chunkCount = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+            MakeWritablePoolsUnique();
+            ThreadPool::Get().ParallelFor(chunkCount, [&](unsigned chunk)
+            {
+                const unsigned begin = chunk * CHUNK_SIZE;
+                FetchChunks(begin, std::min(CHUNK_SIZE, size - begin), func, std::index_sequence_for<Includes...>{});
+            });
+        }
+
+        bool Contains(Entity entity) const
+        {
+            return std::get<0>(m_Pools)->IndexOf(entity) < Size();
+        }
+
+        template <typename T>
+        ComponentReference<T> Get(Entity entity) const
+        {
+            auto* pool = std::get<ComponentArray<std::remove_const_t<T>>*>(m_Pools);
+            if constexpr (std::is_const_v<T>)
+            {
+                return std::as_const(*pool).GetData(entity);
+            }
+            else
+            {
+                return pool->GetData(entity);
+            }
+        }
+
+        unsigned Size() const
+        {
+            return std::get<0>(m_Pools)->GroupSize();
+        }
+
+        // Member i, which is at packed index i of every pool of the group
+        Entity EntityAt(unsigned index) const
+        {
+            return std::get<0>(m_Pools)->EntityAt(index);
+        }
+
+    private:
+        template <typename Func>
+        void EachInRange(unsigned begin, unsigned end, Func& func) const
+        {
+            for (unsigned i = end; i-- > begin;)
+            {
+                Invoke(func, i, std::index_sequence_for<Includes...>{});
+            }
+        }
+
+        template <typename Func, size_t... I>
+        void Invoke(Func& func, unsigned index, std::index_sequence<I...>) const
+        {
+            if constexpr (std::is_invocable_v<Func&, Entity, ComponentReference<Includes>...>)
+            {
+                func(EntityAt(index), Fetch<I>(index)...);
+            }
+            else
+            {
+                func(Fetch<I>(index)...);
+            }
+        }
+
+        template <typename Func, size_t... I>
+        void FetchChunks(unsigned begin, unsigned count, Func& func, std::index_sequence<I...>) const
+        {
+            func(std::get<0>(m_Pools)->EntitiesAt(begin, count), FetchChunk<I>(begin, count)...);
+        }
+
+        // Const components are read through the const pool, so that they never clone a page
+        // shared with a snapshot
+        template <size_t I>
+        decltype(auto) Fetch(unsigned packedIndex) const
+        {
+            using Component = std::tuple_element_t<I, std::tuple<Includes...>>;
+            auto* pool = std::get<I>(m_Pools);
+            if constexpr (std::is_const_v<Component>)
+            {
+                return std::as_const(*pool).At(packedIndex);
+            }
+            else
+            {
+                return pool->At(packedIndex);
+            }
+        }
+
+        template <size_t I>
+        auto FetchChunk(unsigned begin, unsigned count) const
+        {
+            using Component = std::tuple_element_t<I, std::tuple<Includes...>>;
+            auto* pool = std::get<I>(m_Pools);
+            if constexpr (std::is_const_v<Component>)
+            {
+                return std::as_const(*pool).ChunkAt(begin, count);
+            }
+            else
+            {
+                return pool->ChunkAt(begin, count);
+            }
+        }
+
+        // Clones the pages that written pools still share with a snapshot up front, page
+        // ownership is not thread safe
+        void MakeWritablePoolsUnique() const
+        {
+            MakeWritablePoolsUnique(std::index_sequence_for<Includes...>{});
+        }
+
+        template <size_t... I>
+        void MakeWritablePoolsUnique(std::index_sequence<I...>) const
+        {
+            ((std::is_const_v<std::tuple_element_t<I, std::tuple<Includes...>>> ? void() : std::get<I>(m_Pools)->MakeUnique()), ...);
+        }
+
+        std::tuple<ComponentArray<std::remove_const_t<Includes>>*...> m_Pools;
+    };
+}
@@ -0,0 +1,606 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Hazel/Core/Core.h"
+#include "ECSTypeDefs.h"
+
+namespace Hazel
+{
+    // A T built from args, braces for aggregates as C++17 only constructs them from parentheses
+    // when copying or moving. Returned as a prvalue, so callers construct it in place.
+    template <typename T, typename... Args>
+    T MakeElement(Args&&... args)
+    {
+        if constexpr (std::is_aggregate_v<T>)
+        {
+            return T{std::forward<Args>(args)...};
+        }
+        else
+        {
+            return T(std::forward<Args>(args)...);
+        }
+    }
+
+    // Fixed capacity block of elements, the unit that copies of a paged container share.
+    // Elements [0, Count()) are constructed. Storage starts on a cache line boundary.
+    template <typename T>
+    class StoragePage
+    {
+    public:
+        static constexpr size_t ALIGNMENT = std::max(CACHE_LINE_SIZE, alignof(T));
+
+        explicit StoragePage(unsigned capacity)
+            : m_Data(static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(ALIGNMENT)))),
+              m_Capacity(capacity)
+        {
+        }
+
+        // Page over count elements already in memory owned by someone else, e.g. a mapped file.
+        // The memory must have room for capacity elements and stays alive as long as owner does.
+        StoragePage(T* data, unsigned count, unsigned capacity, Ref<void> owner)
+            : m_Data(data), m_Count(count), m_Capacity(capacity), m_Owner(std::move(owner))
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can live in external memory.");
+        }
+
+        StoragePage(const StoragePage&) = delete;
+        StoragePage& operator=(const StoragePage&) = delete;
+
+        ~StoragePage()
+        {
+            if (!m_Owner)
+            {
+                std::destroy_n(m_Data, m_Count);
+                ::operator delete(m_Data, std::align_val_t(ALIGNMENT));
+            }
+        }
+
+        // A fresh page holding copies of the constructed elements. Pages of move-only elements
+        // can only be shared while they are empty.
+        Ref<StoragePage> Clone() const
+        {
+            auto page = CreateRef<StoragePage>(m_Capacity);
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memcpy(page->m_Data, m_Data, m_Count * sizeof(T));
+            }
+            else if constexpr (std::is_copy_constructible_v<T>)
+            {
+                std::uninitialized_copy_n(m_Data, m_Count, page->m_Data);
+            }
+            else
+            {
+                HZ_CORE_ASSERT(m_Count == 0, "Cloning a page of move-only elements.");
+            }
+            page->m_Count = m_Count;
+            return page;
+        }
+
+        template <typename... Args>
+        T& EmplaceBack(Args&&... args)
+        {
+            HZ_CORE_ASSERT(m_Count < m_Capacity, "Storage page overflow.");
+            T* element = new(m_Data + m_Count) T(MakeElement<T>(std::forward<Args>(args)...));
+            ++m_Count;
+            return *element;
+        }
+
+        void PopBack()
+        {
+            m_Data[--m_Count].~T();
+        }
+
+        T* Data()
+        {
+            return m_Data;
+        }
+
+        const T* Data() const
+        {
+            return m_Data;
+        }
+
+        unsigned Count() const
+        {
+            return m_Count;
+        }
+
+    private:
+        T* m_Data;
+        unsigned m_Count = 0;
+        unsigned m_Capacity;
+
+        // Keeps external memory alive, empty if the page allocated its own
+        Ref<void> m_Owner;
+    };
+
+    template <typename T, typename = void>
+    struct IsEqualityComparable : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct IsEqualityComparable<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+        : std::true_type
+    {
+    };
+
+    // Whether two elements hold the same value, for delta encoding. Trivially copyable types are
+    // compared bytewise, types that cannot be compared at all always count as changed.
+    template <typename T>
+    bool SameElement(const T& a, const T& b)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            return std::memcmp(&a, &b, sizeof(T)) == 0;
+        }
+        else if constexpr (IsEqualityComparable<T>::value)
+        {
+            return a == b;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // Elements of an older version of a paged container at the indices where it differs from a
+    // newer version, enough to turn the newer one back into the older one
+    template <typename T>
+    struct ElementDelta
+    {
+        // Ascending indices and the older values stored there
+        std::vector<unsigned> Indices;
+        std::vector<T> Values;
+
+        // Element count of the older version
+        unsigned Size = 0;
+
+        void Add(unsigned index, const T& value)
+        {
+            Indices.push_back(index);
+            Values.push_back(value);
+        }
+
+        size_t GetMemoryUsage() const
+        {
+            return Indices.capacity() * sizeof(unsigned) + Values.capacity() * sizeof(T);
+        }
+    };
+
+    // Vector split into fixed size pages. Copies share their pages and a page is cloned the first
+    // time one of the sharers writes to it, so copying costs O(pages) and memory only grows with
+    // the pages that are actually modified afterwards.
+    //
+    // Reads go through operator[] and never clone. Writes go through Mutable(), which clones a
+    // shared page on first touch. Concurrent Mutable() calls on one vector are only safe after
+    // MakeUnique().
+    template <typename T, unsigned PageSize>
+    class PagedVector
+    {
+        static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "Page size must be a power of two.");
+
+    public:
+        static constexpr unsigned PAGE_SIZE = PageSize;
+        using Page = StoragePage<T>;
+
+        PagedVector() = default;
+
+        // Vector over count elements in external memory that stays alive as long as owner does,
+        // without copying them. The memory must be padded to a whole number of pages.
+        static PagedVector Adopt(T* data, unsigned count, const Ref<void>& owner)
+        {
+            PagedVector vector;
+            for (unsigned begin = 0; begin < count; begin += PageSize)
+            {
+                vector.m_Pages.push_back(CreateRef<Page>(data + begin, std::min(count - begin, PageSize), PageSize, owner));
+                vector.m_PageData.push_back(data + begin);
+                vector.m_Owned.push_back(1);
+            }
+            vector.m_Size = count;
+            return vector;
+        }
+
+        PagedVector(const PagedVector& other)
+            : m_Pages(other.m_Pages), m_PageData(other.m_PageData), m_Size(other.m_Size)
+        {
+            // Both sides now share every page
+            m_Owned.assign(m_Pages.size(), 0);
+            other.m_Owned.assign(other.m_Pages.size(), 0);
+        }
+
+        PagedVector(PagedVector&& other) noexcept
+            : m_Pages(std::move(other.m_Pages)), m_PageData(std::move(other.m_PageData)),
+              m_Owned(std::move(other.m_Owned)), m_Size(std::exchange(other.m_Size, 0))
+        {
+        }
+
+        PagedVector& operator=(const PagedVector& other)
+        {
+            if (this == &other)
+                return *this;
+            m_Pages = other.m_Pages;
+            m_PageData = other.m_PageData;
+            m_Size = other.m_Size;
+            m_Owned.assign(m_Pages.size(), 0);
+            other.m_Owned.assign(other.m_Pages.size(), 0);
+            return *this;
+        }
+
+        PagedVector& operator=(PagedVector&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+            m_Pages = std::move(other.m_Pages);
+            m_PageData = std::move(other.m_PageData);
+            m_Owned = std::move(other.m_Owned);
+            m_Size = std::exchange(other.m_Size, 0);
+            return *this;
+        }
+
+        const T& operator[](unsigned index) const
+        {
+            return m_PageData[index / PageSize][index % PageSize];
+        }
+
+        // Write access, clones the page first if a copy of this vector still shares it
+        T& Mutable(unsigned index)
+        {
+            const unsigned page = index / PageSize;
+            if (!m_Owned[page])
+            {
+                Own(page);
+            }
+            return m_PageData[page][index % PageSize];
+        }
+
+        template <typename... Args>
+        T& EmplaceBack(Args&&... args)
+        {
+            const unsigned page = m_Size / PageSize;
+            if (page == m_Pages.size())
+            {
+                AddPage();
+            }
+            else if (!m_Owned[page])
+            {
+                Own(page);
+            }
+            ++m_Size;
+            return m_Pages[page]->EmplaceBack(std::forward<Args>(args)...);
+        }
+
+        void PopBack()
+        {
+            const unsigned page = (m_Size - 1) / PageSize;
+            if (!m_Owned[page])
+            {
+                Own(page);
+            }
+            m_Pages[page]->PopBack();
+            --m_Size;
+        }
+
+        void Clear()
+        {
+            m_Pages.clear();
+            m_PageData.clear();
+            m_Owned.clear();
+            m_Size = 0;
+        }
+
+        // Allocates pages up front until capacity elements fit
+        void Reserve(unsigned capacity)
+        {
+            while (m_Pages.size() * PageSize < capacity)
+            {
+                AddPage();
+            }
+        }
+
+        // Releases the pages past the last used one
+        void ShrinkToFit()
+        {
+            const unsigned used = PageCount();
+            m_Pages.resize(used);
+            m_PageData.resize(used);
+            m_Owned.resize(used);
+            m_Pages.shrink_to_fit();
+            m_PageData.shrink_to_fit();
+            m_Owned.shrink_to_fit();
+        }
+
+        // Clones every shared page that holds elements, after this Mutable() never allocates
+        void MakeUnique()
+        {
+            for (unsigned page = 0; page < PageCount(); ++page)
+            {
+                if (!m_Owned[page])
+                {
+                    Own(page);
+                }
+            }
+        }
+
+        unsigned Size() const
+        {
+            return m_Size;
+        }
+
+        bool Empty() const
+        {
+            return m_Size == 0;
+        }
+
+        // Number of pages holding elements
+        unsigned PageCount() const
+        {
+            return (m_Size + PageSize - 1) / PageSize;
+        }
+
+        // Page identity, two vectors hold the same data for a page if they point at the same one
+        const Page* PageAt(unsigned page) const
+        {
+            return m_Pages[page].get();
+        }
+
+        // Records what Revert() needs to turn this vector back into older. Pages both still share
+        // are skipped, so the cost follows the number of pages written since older was copied.
+        ElementDelta<T> Diff(const PagedVector& older) const
+        {
+            ElementDelta<T> delta;
+            delta.Size = older.m_Size;
+            for (unsigned page = 0; page < older.PageCount(); ++page)
+            {
+                if (page < m_Pages.size() && m_Pages[page] == older.m_Pages[page])
+                {
+                    continue;
+                }
+                const unsigned end = std::min(older.m_Size, (page + 1) * PageSize);
+                for (unsigned i = page * PageSize; i < end; ++i)
+                {
+                    if (i >= m_Size || !SameElement(older[i], (*this)[i]))
+                    {
+                        delta.Add(i, older[i]);
+                    }
+                }
+            }
+            return delta;
+        }
+
+        void Revert(const ElementDelta<T>& delta)
+        {
+            while (m_Size > delta.Size)
+            {
+                PopBack();
+            }
+            for (unsigned i = 0; i < delta.Indices.size(); ++i)
+            {
+                // Indices past the current size are contiguous, as all of them differ
+                if (delta.Indices[i] < m_Size)
+                {
+                    Mutable(delta.Indices[i]) = delta.Values[i];
+                }
+                else
+                {
+                    EmplaceBack(delta.Values[i]);
+                }
+            }
+        }
+
+    private:
+        void AddPage()
+        {
+            m_Pages.push_back(CreateRef<Page>(PageSize));
+            m_PageData.push_back(m_Pages.back()->Data());
+            m_Owned.push_back(1);
+        }
+
+        void Own(unsigned page)
+        {
+            if (m_Pages[page].use_count() > 1)
+            {
+                m_Pages[page] = m_Pages[page]->Clone();
+                m_PageData[page] = m_Pages[page]->Data();
+            }
+            m_Owned[page] = 1;
+        }
+
+        std::vector<Ref<Page>> m_Pages;
+
+        // m_Pages[i]->Data(), cached to save an indirection per access
+        std::vector<T*> m_PageData;
+
+        // Set for pages known to be referenced by this vector only. Cleared on both sides of a
+        // copy, a cleared page is checked (and cloned if still shared) on its next write.
+        mutable std::vector<unsigned char> m_Owned;
+
+        unsigned m_Size = 0;
+    };
+
+    // Array with a default value for every index, split into pages that are only allocated once an
+    // entry in their range is written. Pages are shared between copies like in PagedVector.
+    template <typename T, unsigned PageSize>
+    class SparsePagedArray
+    {
+        static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "Page size must be a power of two.");
+
+    public:
+        using Page = StoragePage<T>;
+
+        explicit SparsePagedArray(T defaultValue = T()) : m_Default(defaultValue)
+        {
+        }
+
+        // Array over pageCount full pages in external memory that stays alive as long as owner
+        // does, pages[i] covering the indices of page pageIndices[i]. Nothing is copied.
+        static SparsePagedArray Adopt(T defaultValue, const uint32_t* pageIndices, T* pages, unsigned pageCount,
+                                      const Ref<void>& owner)
+        {
+            SparsePagedArray array(defaultValue);
+            for (unsigned i = 0; i < pageCount; ++i)
+            {
+                const unsigned page = pageIndices[i];
+                if (page >= array.m_Pages.size())
+                {
+                    array.m_Pages.resize(page + 1);
+                    array.m_PageData.resize(page + 1, nullptr);
+                    array.m_Owned.resize(page + 1, 0);
+                }
+                T* data = pages + static_cast<size_t>(i) * PageSize;
+                array.m_Pages[page] = CreateRef<Page>(data, PageSize, PageSize, owner);
+                array.m_PageData[page] = data;
+                array.m_Owned[page] = 1;
+            }
+            return array;
+        }
+
+        SparsePagedArray(const SparsePagedArray& other)
+            : m_Pages(other.m_Pages), m_PageData(other.m_PageData), m_Default(other.m_Default)
+        {
+            m_Owned.assign(m_Pages.size(), 0);
+            other.m_Owned.assign(other.m_Pages.size(), 0);
+        }
+
+        SparsePagedArray(SparsePagedArray&& other) noexcept = default;
+
+        SparsePagedArray& operator=(const SparsePagedArray& other)
+        {
+            if (this == &other)
+                return *this;
+            m_Pages = other.m_Pages;
+            m_PageData = other.m_PageData;
+            m_Default = other.m_Default;
+            m_Owned.assign(m_Pages.size(), 0);
+            other.m_Owned.assign(other.m_Pages.size(), 0);
+            return *this;
+        }
+
+        SparsePagedArray& operator=(SparsePagedArray&& other) noexcept = default;
+
+        T Get(unsigned index) const
+        {
+            const unsigned page = index / PageSize;
+            if (page >= m_PageData.size() || !m_PageData[page])
+            {
+                return m_Default;
+            }
+            return m_PageData[page][index % PageSize];
+        }
+
+        // Write access, allocates the page on first touch and clones it if it is shared
+        T& Mutable(unsigned index)
+        {
+            const unsigned page = index / PageSize;
+            if (page >= m_Pages.size())
+            {
+                m_Pages.resize(page + 1);
+                m_PageData.resize(page + 1, nullptr);
+                m_Owned.resize(page + 1, 0);
+            }
+            if (!m_Pages[page])
+            {
+                m_Pages[page] = CreateRef<Page>(PageSize);
+                for (unsigned i = 0; i < PageSize; ++i)
+                {
+                    m_Pages[page]->EmplaceBack(m_Default);
+                }
+                m_PageData[page] = m_Pages[page]->Data();
+                m_Owned[page] = 1;
+            }
+            else if (!m_Owned[page])
+            {
+                if (m_Pages[page].use_count() > 1)
+                {
+                    m_Pages[page] = m_Pages[page]->Clone();
+                    m_PageData[page] = m_Pages[page]->Data();
+                }
+                m_Owned[page] = 1;
+            }
+            return m_PageData[page][index % PageSize];
+        }
+
+        // Records what Revert() needs to turn this array back into older, skipping shared pages
+        ElementDelta<T> Diff(const SparsePagedArray& older) const
+        {
+            ElementDelta<T> delta;
+            const unsigned pageCount = static_cast<unsigned>(std::max(m_Pages.size(), older.m_Pages.size()));
+            for (unsigned page = 0; page < pageCount; ++page)
+            {
+                const Page* newerPage = page < m_Pages.size() ? m_Pages[page].get() : nullptr;
+                const Page* olderPage = page < older.m_Pages.size() ? older.m_Pages[page].get() : nullptr;
+                if (newerPage == olderPage)
+                {
+                    continue;
+                }
+                for (unsigned i = page * PageSize; i < (page + 1) * PageSize; ++i)
+                {
+                    const T value = older.Get(i);
+                    if (!SameElement(value, Get(i)))
+                    {
+                        delta.Add(i, value);
+                    }
+                }
+            }
+            return delta;
+        }
+
+        void Revert(const ElementDelta<T>& delta)
+        {
+            for (unsigned i = 0; i < delta.Indices.size(); ++i)
+            {
+                Mutable(delta.Indices[i]) = delta.Values[i];
+            }
+        }
+
+        // Number of page slots, some of which may be unallocated
+        unsigned PageCount() const
+        {
+            return static_cast<unsigned>(m_Pages.size());
+        }
+
+        // The page covering indices [page * PageSize, (page + 1) * PageSize), nullptr if unallocated
+        const Page* PageAt(unsigned page) const
+        {
+            return m_Pages[page].get();
+        }
+
+        // Drops pages whose entries are all back to the default value
+        void ShrinkToFit()
+        {
+            for (unsigned page = 0; page < m_Pages.size(); ++page)
+            {
+                if (m_Pages[page] && std::all_of(m_PageData[page], m_PageData[page] + PageSize,
+                                                 [this](const T& value) { return value == m_Default; }))
+                {
+                    m_Pages[page].reset();
+                    m_PageData[page] = nullptr;
+                    m_Owned[page] = 0;
+                }
+            }
+            while (!m_Pages.empty() && !m_Pages.back())
+            {
+                m_Pages.pop_back();
+                m_PageData.pop_back();
+                m_Owned.pop_back();
+            }
+            m_Pages.shrink_to_fit();
+            m_PageData.shrink_to_fit();
+            m_Owned.shrink_to_fit();
+        }
+
+    private:
+        std::vector<Ref<Page>> m_Pages;
+        std::vector<T*> m_PageData;
+        mutable std::vector<unsigned char> m_Owned;
+        T m_Default;
+    };
+}
@@ -0,0 +1,172 @@
+#include "hzpch.h"
+#include "PhysicsKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HZ_PHYSICS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC emits AVX intrinsics without /arch:AVX, other compilers need the function to opt in
+#define HZ_TARGET_AVX
+#else
+#define HZ_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace Hazel
+{
+    // The kernels use separate multiplies and adds, never fused ones, so that the scalar, SSE and
+    // AVX versions produce the same bits
+
+#ifndef HZ_PHYSICS_X86
+    static void IntegrateScalar(Integrator integrator, float* positions, float* velocities, const float* accelerations,
+                                unsigned count, float dt, unsigned substeps)
+    {
+        const float halfDtSquared = 0.5f * dt * dt;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            float x = positions[i];
+            float v = velocities[i];
+            const float a = accelerations[i];
+            const float dv = a * dt;
+            const float dx = a * halfDtSquared;
+            for (unsigned step = 0; step < substeps; ++step)
+            {
+                if (integrator == Integrator::SemiImplicitEuler)
+                {
+                    v = v + dv;
+                    x = x + v * dt;
+                }
+                else
+                {
+                    x = x + (v * dt + dx);
+                    v = v + dv;
+                }
+            }
+            positions[i] = x;
+            velocities[i] = v;
+        }
+    }
+#else
+    static void IntegrateSSE(Integrator integrator, float* positions, float* velocities, const float* accelerations,
+                             unsigned count, float dt, unsigned substeps)
+    {
+        const __m128 step = _mm_set1_ps(dt);
+        const __m128 halfStepSquared = _mm_set1_ps(0.5f * dt * dt);
+        for (unsigned i = 0; i < count; i += 4)
+        {
+            __m128 x = _mm_load_ps(positions + i);
+            __m128 v = _mm_load_ps(velocities + i);
+            const __m128 a = _mm_load_ps(accelerations + i);
+            const __m128 dv = _mm_mul_ps(a, step);
+            const __m128 dx = _mm_mul_ps(a, halfStepSquared);
+
+            // The lanes stay in registers for all substeps
+            if (integrator == Integrator::SemiImplicitEuler)
+            {
+                for (unsigned s = 0; s < substeps; ++s)
+                {
+                    v = _mm_add_ps(v, dv);
+                    x = _mm_add_ps(x, _mm_mul_ps(v, step));
+                }
+            }
+            else
+            {
+                for (unsigned s = 0; s < substeps; ++s)
+                {
+                    x = _mm_add_ps(x, _mm_add_ps(_mm_mul_ps(v, step), dx));
+                    v = _mm_add_ps(v, dv);
+                }
+            }
+            _mm_store_ps(positions + i, x);
+            _mm_store_ps(velocities + i, v);
+        }
+    }
+
+    HZ_TARGET_AVX static void IntegrateAVX(Integrator integrator, float* positions, float* velocities,
+                                           const float* accelerations, unsigned count, float dt, unsigned substeps)
+    {
+        const __m256 step = _mm256_set1_ps(dt);
+        const __m256 halfStepSquared = _mm256_set1_ps(0.5f * dt * dt);
+        for (unsigned i = 0; i < count; i += 8)
+        {
+            __m256 x = _mm256_load_ps(positions + i);
+            __m256 v = _mm256_load_ps(velocities + i);
+            const __m256 a = _mm256_load_ps(accelerations + i);
+            const __m256 dv = _mm256_mul_ps(a, step);
+            const __m256 dx = _mm256_mul_ps(a, halfStepSquared);
+
+            if (integrator == Integrator::SemiImplicitEuler)
+            {
+                for (unsigned s = 0; s < substeps; ++s)
+                {
+                    v = _mm256_add_ps(v, dv);
+                    x = _mm256_add_ps(x, _mm256_mul_ps(v, step));
+                }
+            }
+            else
+            {
+                for (unsigned s = 0; s < substeps; ++s)
+                {
+                    x = _mm256_add_ps(x, _mm256_add_ps(_mm256_mul_ps(v, step), dx));
+                    v = _mm256_add_ps(v, dv);
+                }
+            }
+            _mm256_store_ps(positions + i, x);
+            _mm256_store_ps(velocities + i, v);
+        }
+        _mm256_zeroupper();
+    }
+
+    static bool CpuSupportsAVX()
+    {
+#if defined(_MSC_VER)
+        // The CPU must have AVX and the OS must save the upper halves of the registers
+        int info[4];
+        __cpuid(info, 1);
+        const bool osSavesRegisters = (info[2] & (1 << 27)) != 0;
+        const bool hasAVX = (info[2] & (1 << 28)) != 0;
+        return osSavesRegisters && hasAVX && (_xgetbv(0) & 0x6) == 0x6;
+#else
+        return __builtin_cpu_supports("avx");
+#endif
+    }
+#endif
+
+    using IntegrateFunc = void (*)(Integrator, float*, float*, const float*, unsigned, float, unsigned);
+
+    struct PhysicsKernel
+    {
+        IntegrateFunc Integrate;
+        const char* Name;
+    };
+
+    static const PhysicsKernel& GetKernel()
+    {
+        static const PhysicsKernel s_Kernel = []() -> PhysicsKernel
+        {
+#ifdef HZ_PHYSICS_X86
+            if (CpuSupportsAVX())
+            {
+                return {&IntegrateAVX, "AVX"};
+            }
+            return {&IntegrateSSE, "SSE"};
+#else
+            return {&IntegrateScalar, "Scalar"};
+#endif
+        }();
+        return s_Kernel;
+    }
+
+    void IntegrateCoordinates(Integrator integrator, float* positions, float* velocities, const float* accelerations,
+                              unsigned count, float dt, unsigned substeps)
+    {
+        HZ_CORE_ASSERT(count % PHYSICS_KERNEL_WIDTH == 0, "Coordinate count must be a multiple of the kernel width.");
+        GetKernel().Integrate(integrator, positions, velocities, accelerations, count, dt, substeps);
+    }
+
+    const char* GetPhysicsKernelName()
+    {
+        return GetKernel().Name;
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace Hazel
+{
+    enum class Integrator
+    {
+        // v += a dt, then x += v dt
+        SemiImplicitEuler,
+
+        // Velocity Verlet: x += v dt + a dt^2 / 2, then v += a dt
+        Verlet
+    };
+
+    // Element count the kernels process at once, array lengths passed to them are rounded up to it
+    constexpr unsigned PHYSICS_KERNEL_WIDTH = 8;
+
+    // Advances count independent coordinates by substeps steps of dt under a constant acceleration,
+    // in place. The arrays must be 32 byte aligned and count a multiple of PHYSICS_KERNEL_WIDTH.
+    // Uses AVX when the CPU supports it and SSE otherwise. Every path rounds alike, so results do
+    // not depend on the machine.
+    void IntegrateCoordinates(Integrator integrator, float* positions, float* velocities, const float* accelerations,
+                              unsigned count, float dt, unsigned substeps);
+
+    // Name of the instruction set IntegrateCoordinates uses on this machine
+    const char* GetPhysicsKernelName();
+}
@@ -0,0 +1,95 @@
+#include "hzpch.h"
+#include "RewindBuffer.h"
+
+namespace Hazel
+{
+    RewindBuffer::RewindBuffer(unsigned capacity)
+        : m_Capacity(capacity)
+    {
+        HZ_CORE_ASSERT(capacity > 0, "A rewind buffer needs room for at least one frame.");
+        m_Steps.resize(capacity - 1);
+    }
+
+    void RewindBuffer::Record(const ECS& ecs)
+    {
+        HZ_PROFILE_FUNCTION();
+
+        if (!m_HasNewest)
+        {
+            m_Newest = ecs;
+            m_HasNewest = true;
+            return;
+        }
+
+        if (m_Steps.empty())
+        {
+            // Only the newest frame is kept
+            m_Newest = ecs;
+            return;
+        }
+
+        if (m_StepCount == m_Steps.size())
+        {
+            // Drop the step to the oldest frame
+            StepAt(0) = Step();
+            m_FirstStep = (m_FirstStep + 1) % m_Steps.size();
+            --m_StepCount;
+        }
+
+        Step& step = StepAt(m_StepCount++);
+        if (ecs.HasSameLayout(m_Newest))
+        {
+            step.Delta = CreateScope<ECS::Delta>(ecs.Diff(m_Newest));
+        }
+        else
+        {
+            step.Keyframe = CreateScope<ECS>(std::move(m_Newest));
+        }
+        m_Newest = ecs;
+    }
+
+    void RewindBuffer::Restore(ECS& ecs, unsigned framesBack)
+    {
+        HZ_PROFILE_FUNCTION();
+
+        HZ_CORE_ASSERT(framesBack < GetFrameCount(), "Restoring a frame that is not in the rewind buffer.");
+
+        // Walk back from the newest frame, later frames are discarded on the way
+        for (unsigned i = 0; i < framesBack; ++i)
+        {
+            Step& step = StepAt(--m_StepCount);
+            if (step.Keyframe)
+            {
+                m_Newest = std::move(*step.Keyframe);
+            }
+            else
+            {
+                m_Newest.Revert(*step.Delta);
+            }
+            step = Step();
+        }
+        ecs = m_Newest;
+    }
+
+    void RewindBuffer::Clear()
+    {
+        for (Step& step : m_Steps)
+        {
+            step = Step();
+        }
+        m_Newest = ECS();
+        m_HasNewest = false;
+        m_FirstStep = 0;
+        m_StepCount = 0;
+    }
+
+    size_t RewindBuffer::GetMemoryUsage() const
+    {
+        size_t usage = 0;
+        for (const Step& step : m_Steps)
+        {
+            usage += step.Delta ? step.Delta->GetMemoryUsage() : 0;
+        }
+        return usage;
+    }
+}
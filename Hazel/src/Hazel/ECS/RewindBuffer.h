@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include "Hazel/Core/Core.h"
+#include "ECSCore.h"
+
+namespace Hazel
+{
+    // Ring buffer of the last frames of a world, stored as backward deltas from each frame to the one
+    // before it. Only the newest frame is kept whole, as a snapshot that shares its pages with the
+    // world, so memory follows the number of values that change per frame rather than the world size.
+    //
+    // Frames where component types or systems were registered or removed are kept as full snapshots.
+    // Recording copies the systems without the caches they derive from the world. Restoring does not
+    // call OnEntityAdded/OnEntityRemoved, the systems get OnWorldReset() and rebuild their caches
+    // before their next update instead.
+    class RewindBuffer
+    {
+    public:
+        // capacity is the number of frames that can be restored, including the newest one
+        explicit RewindBuffer(unsigned capacity);
+
+        // Stores the current state of ecs as the newest frame, dropping the oldest frame when full
+        void Record(const ECS& ecs);
+
+        // Turns ecs into the frame recorded framesBack frames before the newest one (0 being the newest)
+        // and discards the frames after it, so that recording continues from there
+        void Restore(ECS& ecs, unsigned framesBack);
+
+        void Clear();
+
+        unsigned GetFrameCount() const
+        {
+            return m_HasNewest ? m_StepCount + 1 : 0;
+        }
+
+        unsigned GetCapacity() const
+        {
+            return m_Capacity;
+        }
+
+        // Bytes held by the deltas, not counting the pages the newest frame shares with the world
+        size_t GetMemoryUsage() const;
+
+    private:
+        // Turns one frame into the frame recorded before it
+        struct Step
+        {
+            Scope<ECS::Delta> Delta;
+
+            // Set instead of Delta when the layout of the world changed between the two frames
+            Scope<ECS> Keyframe;
+        };
+
+        Step& StepAt(unsigned index)
+        {
+            return m_Steps[(m_FirstStep + index) % m_Steps.size()];
+        }
+
+        unsigned m_Capacity;
+
+        // The newest frame
+        ECS m_Newest;
+        bool m_HasNewest = false;
+
+        // Ring of capacity - 1 steps, the oldest one at m_FirstStep
+        std::vector<Step> m_Steps;
+        unsigned m_FirstStep = 0;
+        unsigned m_StepCount = 0;
+    };
+}
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Hazel/Core/Core.h"
+#include "ComponentTraits.h"
+#include "PagedVector.h"
+
+namespace Hazel
+{
+    // Position of a value in the table of a shared component type
+    using SharedIndex = uint32_t;
+
+    constexpr SharedIndex INVALID_SHARED_INDEX = ~0u;
+
+    // The distinct values of a shared component type, each stored once along with the number of
+    // components referring to it. Slots of values no longer referred to are reused.
+    template <typename T>
+    class SharedValueTable
+    {
+    public:
+        // Index of the value equal to the given one, which is added if there is none yet.
+        // Counts one more reference to it.
+        template <typename Value>
+        SharedIndex Acquire(Value&& value)
+        {
+            // Components are mostly added in runs of the same value, e.g. a batch of sprites
+            if (m_Last < m_Values.size() && m_References[m_Last] > 0 && m_Values[m_Last] == value)
+            {
+                ++m_References[m_Last];
+                return m_Last;
+            }
+
+            const size_t hash = ComponentTraits<T>::Hash(value);
+            for (auto [it, end] = m_Lookup.equal_range(hash); it != end; ++it)
+            {
+                if (m_Values[it->second] == value)
+                {
+                    ++m_References[it->second];
+                    m_Last = it->second;
+                    return it->second;
+                }
+            }
+
+            SharedIndex index;
+            if (!m_Free.empty())
+            {
+                index = m_Free.back();
+                m_Free.pop_back();
+                m_Values[index] = std::forward<Value>(value);
+                m_References[index] = 1;
+            }
+            else
+            {
+                index = static_cast<SharedIndex>(m_Values.size());
+                m_Values.push_back(std::forward<Value>(value));
+                m_References.push_back(1);
+            }
+            m_Lookup.emplace(hash, index);
+            m_Last = index;
+            return index;
+        }
+
+        // Drops one reference, the last one frees the slot and whatever the value holds on to
+        void Release(SharedIndex index)
+        {
+            HZ_CORE_ASSERT(m_References[index] > 0, "Releasing a shared value that is not referred to.");
+            if (--m_References[index] > 0)
+            {
+                return;
+            }
+
+            for (auto [it, end] = m_Lookup.equal_range(ComponentTraits<T>::Hash(m_Values[index])); it != end; ++it)
+            {
+                if (it->second == index)
+                {
+                    m_Lookup.erase(it);
+                    break;
+                }
+            }
+            m_Values[index] = T();
+            m_Free.push_back(index);
+        }
+
+        const T& operator[](SharedIndex index) const
+        {
+            return m_Values[index];
+        }
+
+        // Replaces the table by values, value i being referred to references[i] times. Slots
+        // without references are free.
+        void Load(std::vector<T> values, std::vector<unsigned> references)
+        {
+            HZ_CORE_ASSERT(values.size() == references.size(), "Value and reference counts differ.");
+            m_Values = std::move(values);
+            m_References = std::move(references);
+            m_Free.clear();
+            m_Lookup.clear();
+            m_Last = INVALID_SHARED_INDEX;
+            for (SharedIndex index = 0; index < m_Values.size(); ++index)
+            {
+                if (m_References[index] > 0)
+                {
+                    m_Lookup.emplace(ComponentTraits<T>::Hash(m_Values[index]), index);
+                }
+                else
+                {
+                    m_Values[index] = T();
+                    m_Free.push_back(index);
+                }
+            }
+        }
+
+        // Number of components referring to the value
+        unsigned References(SharedIndex index) const
+        {
+            return m_References[index];
+        }
+
+        // Number of distinct values
+        unsigned Count() const
+        {
+            return static_cast<unsigned>(m_Values.size() - m_Free.size());
+        }
+
+        // One past the highest index in use, for arrays indexed by SharedIndex
+        unsigned Capacity() const
+        {
+            return static_cast<unsigned>(m_Values.size());
+        }
+
+        size_t GetMemoryUsage() const
+        {
+            return m_Values.capacity() * sizeof(T) + m_References.capacity() * sizeof(unsigned) +
+                m_Free.capacity() * sizeof(SharedIndex) + m_Lookup.size() * (sizeof(size_t) + sizeof(SharedIndex));
+        }
+
+    private:
+        std::vector<T> m_Values;
+        std::vector<unsigned> m_References;
+        std::vector<SharedIndex> m_Free;
+
+        // Indices of the values by hash
+        std::unordered_multimap<size_t, SharedIndex> m_Lookup;
+
+        // The value acquired most recently
+        SharedIndex m_Last = INVALID_SHARED_INDEX;
+    };
+
+    // Packed components of type T stored as indices into a table of their distinct values. Equal
+    // components take the size of an index and are moved, compared and sorted as integers, and
+    // adding one equal to an existing value copies nothing. The table is shared between copies of
+    // the storage until either side adds or removes a component, like the pages are. Offers the
+    // subset of the PagedVector interface that component pools use, values are read-only.
+    template <typename T, unsigned PageSize>
+    class SharedStorage
+    {
+        static_assert(std::is_default_constructible_v<T>, "Shared components must be default constructible.");
+
+    public:
+        static constexpr unsigned PAGE_SIZE = PageSize;
+
+        // Older indices, and the older table if it was replaced since
+        struct Delta : ElementDelta<SharedIndex>
+        {
+            Ref<SharedValueTable<T>> Values;
+
+            size_t GetMemoryUsage() const
+            {
+                return ElementDelta<SharedIndex>::GetMemoryUsage() + (Values ? Values->GetMemoryUsage() : 0);
+            }
+        };
+
+        // Storage over loaded indices into values, references[i] being the number of indices equal
+        // to i. The indices are kept as they are, e.g. adopted from a mapped file.
+        static SharedStorage Load(PagedVector<SharedIndex, PageSize> indices, std::vector<T> values,
+                                  std::vector<unsigned> references)
+        {
+            SharedStorage storage;
+            storage.m_Indices = std::move(indices);
+            storage.m_Values->Load(std::move(values), std::move(references));
+            return storage;
+        }
+
+        const T& operator[](unsigned index) const
+        {
+            return (*m_Values)[m_Indices[index]];
+        }
+
+        SharedIndex IndexAt(unsigned index) const
+        {
+            return m_Indices[index];
+        }
+
+        void EmplaceBack(T value)
+        {
+            m_Indices.EmplaceBack(MutableValues().Acquire(std::move(value)));
+        }
+
+        void PopBack()
+        {
+            MutableValues().Release(m_Indices[m_Indices.Size() - 1]);
+            m_Indices.PopBack();
+        }
+
+        // Points the component at the value equal to the given one
+        void Replace(unsigned index, T value)
+        {
+            SharedValueTable<T>& values = MutableValues();
+            const SharedIndex replaced = m_Indices[index];
+            m_Indices.Mutable(index) = values.Acquire(std::move(value));
+            values.Release(replaced);
+        }
+
+        void Swap(unsigned first, unsigned second)
+        {
+            std::swap(m_Indices.Mutable(first), m_Indices.Mutable(second));
+        }
+
+        void Clear()
+        {
+            m_Indices.Clear();
+            m_Values = CreateRef<SharedValueTable<T>>();
+        }
+
+        void Reserve(unsigned capacity)
+        {
+            m_Indices.Reserve(capacity);
+        }
+
+        void ShrinkToFit()
+        {
+            m_Indices.ShrinkToFit();
+        }
+
+        void MakeUnique()
+        {
+            m_Indices.MakeUnique();
+        }
+
+        unsigned Size() const
+        {
+            return m_Indices.Size();
+        }
+
+        bool Empty() const
+        {
+            return Size() == 0;
+        }
+
+        const SharedValueTable<T>& Values() const
+        {
+            return *m_Values;
+        }
+
+        const PagedVector<SharedIndex, PageSize>& Indices() const
+        {
+            return m_Indices;
+        }
+
+        Delta Diff(const SharedStorage& older) const
+        {
+            Delta delta;
+            static_cast<ElementDelta<SharedIndex>&>(delta) = m_Indices.Diff(older.m_Indices);
+            if (m_Values != older.m_Values)
+            {
+                delta.Values = older.m_Values;
+            }
+            return delta;
+        }
+
+        void Revert(const Delta& delta)
+        {
+            m_Indices.Revert(delta);
+            if (delta.Values)
+            {
+                m_Values = delta.Values;
+            }
+        }
+
+    private:
+        // Clones the table first if a copy of the storage still shares it
+        SharedValueTable<T>& MutableValues()
+        {
+            if (!m_Values)
+            {
+                m_Values = CreateRef<SharedValueTable<T>>();
+            }
+            else if (m_Values.use_count() > 1)
+            {
+                m_Values = CreateRef<SharedValueTable<T>>(*m_Values);
+            }
+            return *m_Values;
+        }
+
+        PagedVector<SharedIndex, PageSize> m_Indices;
+        Ref<SharedValueTable<T>> m_Values = CreateRef<SharedValueTable<T>>();
+    };
+}
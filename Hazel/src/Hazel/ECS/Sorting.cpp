@@ -0,0 +1,95 @@
+#include "hzpch.h"
+#include "Sorting.h"
+
+namespace Hazel
+{
+    namespace
+    {
+        struct KeyedIndex
+        {
+            uint64_t Key;
+            unsigned Index;
+        };
+
+        // Stable, one counting pass per byte in which the keys differ
+        void RadixSort(std::vector<KeyedIndex>& items)
+        {
+            constexpr unsigned BYTES = sizeof(uint64_t);
+            std::vector<size_t> counts(BYTES * 256, 0);
+            for (const KeyedIndex& item : items)
+            {
+                for (unsigned byte = 0; byte < BYTES; ++byte)
+                {
+                    ++counts[byte * 256 + (item.Key >> (byte * 8) & 0xFF)];
+                }
+            }
+
+            std::vector<KeyedIndex> buffer(items.size());
+            for (unsigned byte = 0; byte < BYTES; ++byte)
+            {
+                size_t* histogram = &counts[byte * 256];
+                if (std::find(histogram, histogram + 256, items.size()) != histogram + 256)
+                {
+                    // Every key has the same value in this byte
+                    continue;
+                }
+
+                size_t offset = 0;
+                for (unsigned digit = 0; digit < 256; ++digit)
+                {
+                    const size_t count = histogram[digit];
+                    histogram[digit] = offset;
+                    offset += count;
+                }
+                for (const KeyedIndex& item : items)
+                {
+                    buffer[histogram[item.Key >> (byte * 8) & 0xFF]++] = item;
+                }
+                items.swap(buffer);
+            }
+        }
+    }
+
+    bool SortOrderByKey(const std::vector<uint64_t>& keys, std::vector<unsigned>& order)
+    {
+        const unsigned count = static_cast<unsigned>(keys.size());
+        order.resize(count);
+
+        // Most frames nothing moved, one pass tells
+        if (std::is_sorted(keys.begin(), keys.end()))
+        {
+            std::iota(order.begin(), order.end(), 0u);
+            return false;
+        }
+
+        std::vector<KeyedIndex> items(count);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            items[i] = {keys[i], i};
+        }
+
+        size_t budget = count * INSERTION_SORT_BUDGET;
+        for (unsigned i = 1; i < count && budget > 0; ++i)
+        {
+            const KeyedIndex moving = items[i];
+            unsigned j = i;
+            for (; j > 0 && moving.Key < items[j - 1].Key && budget > 0; --j, --budget)
+            {
+                items[j] = items[j - 1];
+            }
+            items[j] = moving;
+        }
+
+        // Out of budget: the prefix is sorted, equal keys are still in their original order
+        if (budget == 0)
+        {
+            RadixSort(items);
+        }
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            order[i] = items[i].Index;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace Hazel
+{
+    // Elements an insertion sort may shift per element sorted before the sorts below give up on it,
+    // enough for a few keys that moved a little since the previous sort
+    constexpr size_t INSERTION_SORT_BUDGET = 4;
+
+    // Fills order with 0..count-1 sorted by less(i, j), stably. Starts with an insertion sort, which
+    // is close to linear on almost sorted input, e.g. a pool sorted every frame, and falls back to
+    // std::stable_sort once too many elements are out of place. Returns whether the order differs
+    // from 0..count-1.
+    template <typename Less>
+    bool SortOrder(unsigned count, Less less, std::vector<unsigned>& order)
+    {
+        order.resize(count);
+        std::iota(order.begin(), order.end(), 0u);
+
+        size_t budget = count * INSERTION_SORT_BUDGET;
+        bool moved = false;
+        for (unsigned i = 1; i < count; ++i)
+        {
+            const unsigned moving = order[i];
+            unsigned j = i;
+            for (; j > 0 && less(moving, order[j - 1]); --j)
+            {
+                if (budget-- == 0)
+                {
+                    // Equal elements kept their relative order so far, so the result stays stable
+                    order[j] = moving;
+                    std::stable_sort(order.begin(), order.end(), less);
+                    return true;
+                }
+                order[j] = order[j - 1];
+            }
+            order[j] = moving;
+            moved |= j != i;
+        }
+        return moved;
+    }
+
+    // Like SortOrder, ordered by ascending keys[i]. Falls back to an LSD radix sort, which skips the
+    // bytes that are equal across all keys.
+    bool SortOrderByKey(const std::vector<uint64_t>& keys, std::vector<unsigned>& order);
+}
@@ -0,0 +1,319 @@
+#include "hzpch.h"
+#include "SpatialIndex.h"
+
+#include "Hazel/Debug/Instrumentor.h"
+
+namespace Hazel
+{
+    AABB TransformBounds(const Transform& transform)
+    {
+        const glm::vec2 halfSize = transform.Size * 0.5f;
+        if (transform.Rotation == 0.0f)
+        {
+            return AABB::FromCenter(glm::vec2(transform.Position), halfSize);
+        }
+
+        const float radians = glm::radians(transform.Rotation);
+        const float cosine = std::abs(std::cos(radians));
+        const float sine = std::abs(std::sin(radians));
+        const glm::vec2 halfExtents = {cosine * halfSize.x + sine * halfSize.y, sine * halfSize.x + cosine * halfSize.y};
+        return AABB::FromCenter(glm::vec2(transform.Position), halfExtents);
+    }
+
+    // -----------------------------------------------------------------
+    // Spatial Hash Grid
+    // -----------------------------------------------------------------
+    SpatialHashGrid::SpatialHashGrid(float cellSize) : m_CellSize(cellSize), m_InverseCellSize(1.0f / cellSize)
+    {
+        HZ_CORE_ASSERT(cellSize > 0.0f, "Grid cells need a positive size.");
+    }
+
+    void SpatialHashGrid::Insert(Entity entity, const AABB& bounds)
+    {
+        HZ_CORE_ASSERT(!Contains(entity), "Entity inserted into the grid more than once.");
+
+        const unsigned index = EntityIndex(entity);
+        if (index >= m_Locations.size())
+        {
+            m_Locations.resize(index + 1);
+        }
+
+        const uint64_t key = KeyOf(CellOf(bounds.GetCenter()));
+        auto& entries = m_Cells[key];
+        m_Locations[index] = {entity, key, static_cast<unsigned>(entries.size())};
+        entries.push_back({entity, bounds});
+
+        const glm::vec2 halfExtents = bounds.GetHalfExtents();
+        m_MaxHalfExtent = std::max(m_MaxHalfExtent, std::max(halfExtents.x, halfExtents.y));
+        ++m_Count;
+    }
+
+    void SpatialHashGrid::Update(Entity entity, const AABB& bounds)
+    {
+        const unsigned index = EntityIndex(entity);
+        if (index < m_Locations.size() && m_Locations[index].Handle != NULL_ENTITY)
+        {
+            const Location location = m_Locations[index];
+            if (location.Handle == entity && location.Cell == KeyOf(CellOf(bounds.GetCenter())))
+            {
+                // Still in the same cell, only the bounds change
+                m_Cells[location.Cell][location.Slot].Bounds = bounds;
+                const glm::vec2 halfExtents = bounds.GetHalfExtents();
+                m_MaxHalfExtent = std::max(m_MaxHalfExtent, std::max(halfExtents.x, halfExtents.y));
+                return;
+            }
+
+            // Moved to another cell, or the slot was reused by a new entity
+            Erase(location);
+        }
+        Insert(entity, bounds);
+    }
+
+    bool SpatialHashGrid::Remove(Entity entity)
+    {
+        if (!Contains(entity))
+        {
+            return false;
+        }
+        Erase(m_Locations[EntityIndex(entity)]);
+        return true;
+    }
+
+    bool SpatialHashGrid::Contains(Entity entity) const
+    {
+        const unsigned index = EntityIndex(entity);
+        return index < m_Locations.size() && m_Locations[index].Handle == entity;
+    }
+
+    void SpatialHashGrid::Clear()
+    {
+        m_Cells.clear();
+        m_Locations.clear();
+        m_MaxHalfExtent = 0.0f;
+        m_Count = 0;
+    }
+
+    void SpatialHashGrid::Erase(const Location& location)
+    {
+        // Swap-and-pop within the cell, empty cells are dropped
+        auto it = m_Cells.find(location.Cell);
+        auto& entries = it->second;
+        if (location.Slot != entries.size() - 1)
+        {
+            entries[location.Slot] = entries.back();
+            m_Locations[EntityIndex(entries[location.Slot].Handle)].Slot = location.Slot;
+        }
+        entries.pop_back();
+        if (entries.empty())
+        {
+            m_Cells.erase(it);
+        }
+
+        m_Locations[EntityIndex(location.Handle)] = Location();
+        --m_Count;
+    }
+
+    // -----------------------------------------------------------------
+    // Loose Quadtree
+    // -----------------------------------------------------------------
+    LooseQuadtree::LooseQuadtree(const AABB& worldBounds, unsigned maxDepth) : m_MaxDepth(maxDepth)
+    {
+        const glm::vec2 halfExtents = worldBounds.GetHalfExtents();
+        m_Nodes.push_back({worldBounds.GetCenter(), std::max(halfExtents.x, halfExtents.y), NO_CHILDREN, {}});
+    }
+
+    void LooseQuadtree::Insert(Entity entity, const AABB& bounds)
+    {
+        HZ_CORE_ASSERT(!Contains(entity), "Entity inserted into the quadtree more than once.");
+
+        const unsigned index = EntityIndex(entity);
+        if (index >= m_Locations.size())
+        {
+            m_Locations.resize(index + 1);
+        }
+
+        const unsigned node = FindNode(bounds);
+        auto& entries = m_Nodes[node].Entries;
+        m_Locations[index] = {entity, node, static_cast<unsigned>(entries.size())};
+        entries.push_back({entity, bounds});
+        ++m_Count;
+    }
+
+    void LooseQuadtree::Update(Entity entity, const AABB& bounds)
+    {
+        const unsigned index = EntityIndex(entity);
+        if (index < m_Locations.size() && m_Locations[index].Handle != NULL_ENTITY)
+        {
+            const Location location = m_Locations[index];
+            if (location.Handle == entity && location.Node == FindNode(bounds))
+            {
+                m_Nodes[location.Node].Entries[location.Slot].Bounds = bounds;
+                return;
+            }
+            Erase(location);
+        }
+        Insert(entity, bounds);
+    }
+
+    bool LooseQuadtree::Remove(Entity entity)
+    {
+        if (!Contains(entity))
+        {
+            return false;
+        }
+        Erase(m_Locations[EntityIndex(entity)]);
+        return true;
+    }
+
+    bool LooseQuadtree::Contains(Entity entity) const
+    {
+        const unsigned index = EntityIndex(entity);
+        return index < m_Locations.size() && m_Locations[index].Handle == entity;
+    }
+
+    void LooseQuadtree::Clear()
+    {
+        m_Nodes.resize(1);
+        m_Nodes[0].FirstChild = NO_CHILDREN;
+        m_Nodes[0].Entries.clear();
+        m_Locations.clear();
+        m_Count = 0;
+    }
+
+    unsigned LooseQuadtree::FindNode(const AABB& bounds)
+    {
+        const glm::vec2 center = bounds.GetCenter();
+        const glm::vec2 halfExtents = bounds.GetHalfExtents();
+        const float extent = std::max(halfExtents.x, halfExtents.y);
+
+        const Node& root = m_Nodes[0];
+        if (std::abs(center.x - root.Center.x) > root.HalfSize || std::abs(center.y - root.Center.y) > root.HalfSize)
+        {
+            return 0;
+        }
+
+        unsigned node = 0;
+        for (unsigned depth = 0; depth < m_MaxDepth; ++depth)
+        {
+            const float childHalfSize = 0.5f * m_Nodes[node].HalfSize;
+            if (extent > childHalfSize)
+            {
+                break;
+            }
+
+            if (m_Nodes[node].FirstChild == NO_CHILDREN)
+            {
+                const glm::vec2 parentCenter = m_Nodes[node].Center;
+                m_Nodes[node].FirstChild = static_cast<unsigned>(m_Nodes.size());
+                for (unsigned child = 0; child < 4; ++child)
+                {
+                    const glm::vec2 offset = {child & 1 ? childHalfSize : -childHalfSize, child & 2 ? childHalfSize : -childHalfSize};
+                    m_Nodes.push_back({parentCenter + offset, childHalfSize, NO_CHILDREN, {}});
+                }
+            }
+
+            const Node& parent = m_Nodes[node];
+            const unsigned quadrant = (center.x >= parent.Center.x ? 1 : 0) | (center.y >= parent.Center.y ? 2 : 0);
+            node = parent.FirstChild + quadrant;
+        }
+        return node;
+    }
+
+    void LooseQuadtree::Erase(const Location& location)
+    {
+        auto& entries = m_Nodes[location.Node].Entries;
+        if (location.Slot != entries.size() - 1)
+        {
+            entries[location.Slot] = entries.back();
+            m_Locations[EntityIndex(entries[location.Slot].Handle)].Slot = location.Slot;
+        }
+        entries.pop_back();
+
+        m_Locations[EntityIndex(location.Handle)] = Location();
+        --m_Count;
+    }
+
+    // -----------------------------------------------------------------
+    // Spatial Index
+    // -----------------------------------------------------------------
+    SpatialIndex::SpatialIndex(float cellSize, const AABB& worldBounds) : m_Grid(cellSize), m_Tree(worldBounds)
+    {
+    }
+
+    void SpatialIndex::Update(Entity entity, const AABB& bounds)
+    {
+        if (FitsGrid(bounds))
+        {
+            m_Tree.Remove(entity);
+            m_Grid.Update(entity, bounds);
+        }
+        else
+        {
+            m_Grid.Remove(entity);
+            m_Tree.Update(entity, bounds);
+        }
+    }
+
+    void SpatialIndex::UpdateBatch(const std::vector<SpatialEntry>& entries)
+    {
+        HZ_PROFILE_FUNCTION();
+
+        for (const SpatialEntry& entry : entries)
+        {
+            Update(entry.Handle, entry.Bounds);
+        }
+    }
+
+    bool SpatialIndex::Remove(Entity entity)
+    {
+        return m_Grid.Remove(entity) || m_Tree.Remove(entity);
+    }
+
+    bool SpatialIndex::Contains(Entity entity) const
+    {
+        return m_Grid.Contains(entity) || m_Tree.Contains(entity);
+    }
+
+    void SpatialIndex::Clear()
+    {
+        m_Grid.Clear();
+        m_Tree.Clear();
+    }
+
+    std::vector<Entity> SpatialIndex::QueryNearest(const glm::vec2& point, unsigned k) const
+    {
+        std::vector<std::pair<float, Entity>> candidates;
+        if (k == 0 || Size() == 0)
+        {
+            return {};
+        }
+
+        // Grow the radius until it holds k entries, those are then the k nearest. An unbounded
+        // query would visit everything, so stop growing once every entry has been seen.
+        float radius = m_Grid.GetCellSize();
+        while (true)
+        {
+            candidates.clear();
+            QueryRadius(point, radius, [&](const SpatialEntry& entry)
+            {
+                candidates.emplace_back(entry.Bounds.DistanceSquared(point), entry.Handle);
+            });
+            if (candidates.size() >= k || candidates.size() == Size())
+            {
+                break;
+            }
+            radius *= 2.0f;
+        }
+
+        const size_t count = std::min<size_t>(k, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+
+        std::vector<Entity> nearest;
+        nearest.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            nearest.push_back(candidates[i].second);
+        }
+        return nearest;
+    }
+}
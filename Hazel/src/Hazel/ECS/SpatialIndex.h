@@ -0,0 +1,281 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Hazel/Core/AABB.h"
+#include "Components.h"
+#include "ECSTypeDefs.h"
+
+namespace Hazel
+{
+    struct SpatialEntry
+    {
+        Entity Handle;
+        AABB Bounds;
+    };
+
+    // Bounds of a quad drawn from the transform, including its rotation
+    AABB TransformBounds(const Transform& transform);
+
+    // Uniform grid hash. Entries are filed under the cell of their center only, so moving one is
+    // O(1) and queries grow by the largest half extent ever inserted. Best for entries of similar
+    // size up to a cell.
+    class SpatialHashGrid
+    {
+    public:
+        explicit SpatialHashGrid(float cellSize = 1.0f);
+
+        void Insert(Entity entity, const AABB& bounds);
+
+        // Inserts the entity if it is not in the grid yet
+        void Update(Entity entity, const AABB& bounds);
+        bool Remove(Entity entity);
+        bool Contains(Entity entity) const;
+        void Clear();
+
+        // Calls func(entry) for every entry whose bounds intersect range
+        template <typename Func>
+        void Query(const AABB& range, Func func) const
+        {
+            if (m_Count == 0)
+            {
+                return;
+            }
+
+            const AABB grown = range.Expanded(m_MaxHalfExtent);
+            const glm::ivec2 first = CellOf(grown.Min);
+            const glm::ivec2 last = CellOf(grown.Max);
+            const uint64_t cellCount = uint64_t(last.x - first.x + 1) * uint64_t(last.y - first.y + 1);
+
+            const auto visit = [&range, &func](const std::vector<SpatialEntry>& entries)
+            {
+                for (const SpatialEntry& entry : entries)
+                {
+                    if (entry.Bounds.Intersects(range))
+                    {
+                        func(entry);
+                    }
+                }
+            };
+
+            // Ranges spanning more cells than are occupied walk the occupied ones instead
+            if (cellCount > m_Cells.size())
+            {
+                for (const auto& [key, entries] : m_Cells)
+                {
+                    const glm::ivec2 cell = CellOfKey(key);
+                    if (cell.x >= first.x && cell.x <= last.x && cell.y >= first.y && cell.y <= last.y)
+                    {
+                        visit(entries);
+                    }
+                }
+                return;
+            }
+
+            for (int y = first.y; y <= last.y; ++y)
+            {
+                for (int x = first.x; x <= last.x; ++x)
+                {
+                    const auto it = m_Cells.find(KeyOf({x, y}));
+                    if (it != m_Cells.end())
+                    {
+                        visit(it->second);
+                    }
+                }
+            }
+        }
+
+        float GetCellSize() const
+        {
+            return m_CellSize;
+        }
+
+        size_t Size() const
+        {
+            return m_Count;
+        }
+
+    private:
+        struct Location
+        {
+            Entity Handle = NULL_ENTITY;
+            uint64_t Cell = 0;
+            unsigned Slot = 0;
+        };
+
+        glm::ivec2 CellOf(const glm::vec2& point) const
+        {
+            return glm::ivec2(glm::floor(point * m_InverseCellSize));
+        }
+
+        static uint64_t KeyOf(const glm::ivec2& cell)
+        {
+            return (uint64_t(uint32_t(cell.x)) << 32) | uint32_t(cell.y);
+        }
+
+        static glm::ivec2 CellOfKey(uint64_t key)
+        {
+            return {int32_t(uint32_t(key >> 32)), int32_t(uint32_t(key))};
+        }
+
+        void Erase(const Location& location);
+
+        std::unordered_map<uint64_t, std::vector<SpatialEntry>> m_Cells;
+
+        // Indexed by entity slot
+        std::vector<Location> m_Locations;
+
+        float m_CellSize;
+        float m_InverseCellSize;
+        float m_MaxHalfExtent = 0.0f;
+        size_t m_Count = 0;
+    };
+
+    // Loose quadtree: an entry lives in the deepest node that is at least as large as the entry and
+    // contains its center. Node bounds are doubled for queries, so entries never straddle nodes and
+    // entries of any size can be mixed. Entries outside the world bounds stay in the root.
+    class LooseQuadtree
+    {
+    public:
+        explicit LooseQuadtree(const AABB& worldBounds = {{-1024.0f, -1024.0f}, {1024.0f, 1024.0f}}, unsigned maxDepth = 10);
+
+        void Insert(Entity entity, const AABB& bounds);
+
+        // Inserts the entity if it is not in the tree yet
+        void Update(Entity entity, const AABB& bounds);
+        bool Remove(Entity entity);
+        bool Contains(Entity entity) const;
+        void Clear();
+
+        // Calls func(entry) for every entry whose bounds intersect range
+        template <typename Func>
+        void Query(const AABB& range, Func func) const
+        {
+            if (m_Count == 0)
+            {
+                return;
+            }
+
+            std::vector<unsigned> stack;
+            stack.reserve(4 * m_MaxDepth + 1);
+            stack.push_back(0);
+            while (!stack.empty())
+            {
+                const Node& node = m_Nodes[stack.back()];
+                const bool isRoot = stack.back() == 0;
+                stack.pop_back();
+
+                if (!isRoot && !AABB::FromCenter(node.Center, glm::vec2(2.0f * node.HalfSize)).Intersects(range))
+                {
+                    continue;
+                }
+                for (const SpatialEntry& entry : node.Entries)
+                {
+                    if (entry.Bounds.Intersects(range))
+                    {
+                        func(entry);
+                    }
+                }
+                if (node.FirstChild != NO_CHILDREN)
+                {
+                    for (unsigned child = 0; child < 4; ++child)
+                    {
+                        stack.push_back(node.FirstChild + child);
+                    }
+                }
+            }
+        }
+
+        size_t Size() const
+        {
+            return m_Count;
+        }
+
+    private:
+        static constexpr unsigned NO_CHILDREN = ~0u;
+
+        struct Node
+        {
+            glm::vec2 Center;
+            float HalfSize;
+            unsigned FirstChild = NO_CHILDREN;
+            std::vector<SpatialEntry> Entries;
+        };
+
+        struct Location
+        {
+            Entity Handle = NULL_ENTITY;
+            unsigned Node = 0;
+            unsigned Slot = 0;
+        };
+
+        // The node bounds belong in, splitting nodes on the way
+        unsigned FindNode(const AABB& bounds);
+        void Erase(const Location& location);
+
+        std::vector<Node> m_Nodes;
+
+        // Indexed by entity slot
+        std::vector<Location> m_Locations;
+
+        unsigned m_MaxDepth;
+        size_t m_Count = 0;
+    };
+
+    // Keeps entries that fit into a grid cell in a SpatialHashGrid and larger ones in a LooseQuadtree,
+    // queries look into both
+    class SpatialIndex
+    {
+    public:
+        explicit SpatialIndex(float cellSize = 1.0f, const AABB& worldBounds = {{-1024.0f, -1024.0f}, {1024.0f, 1024.0f}});
+
+        // Inserts the entity if it is not indexed yet, moves it otherwise
+        void Update(Entity entity, const AABB& bounds);
+        void UpdateBatch(const std::vector<SpatialEntry>& entries);
+        bool Remove(Entity entity);
+        bool Contains(Entity entity) const;
+        void Clear();
+
+        // Calls func(entry) for every entry whose bounds intersect range
+        template <typename Func>
+        void Query(const AABB& range, Func func) const
+        {
+            m_Grid.Query(range, func);
+            m_Tree.Query(range, func);
+        }
+
+        // Calls func(entry) for every entry whose bounds come within radius of center
+        template <typename Func>
+        void QueryRadius(const glm::vec2& center, float radius, Func func) const
+        {
+            const float radiusSquared = radius * radius;
+            Query(AABB::FromCenter(center, glm::vec2(radius)), [&](const SpatialEntry& entry)
+            {
+                if (entry.Bounds.DistanceSquared(center) <= radiusSquared)
+                {
+                    func(entry);
+                }
+            });
+        }
+
+        // Up to k entities, nearest first by the distance from point to their bounds
+        std::vector<Entity> QueryNearest(const glm::vec2& point, unsigned k) const;
+
+        size_t Size() const
+        {
+            return m_Grid.Size() + m_Tree.Size();
+        }
+
+    private:
+        bool FitsGrid(const AABB& bounds) const
+        {
+            const glm::vec2 halfExtents = bounds.GetHalfExtents();
+            return std::max(halfExtents.x, halfExtents.y) <= 0.5f * m_Grid.GetCellSize();
+        }
+
+        SpatialHashGrid m_Grid;
+        LooseQuadtree m_Tree;
+    };
+}
@@ -5,6 +5,8 @@
 #include "ECSCore.h"
 #include "Hazel/Renderer/Renderer2D.h"
 
+#include <cstring>
+
 namespace Hazel
 {
   
@@ -12,6 +14,17 @@ namespace Hazel
     // -----------------------------------------------------------------
     // Renderer System
     // -----------------------------------------------------------------
+    namespace
+    {
+        // The bits of a float, ordered like the float when compared as unsigned integers
+        uint32_t SortableDepth(float depth)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &depth, sizeof(bits));
+            return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+        }
+    }
+
     RendererSystem::RendererSystem(ECS* ecs) : System(ecs)
     {
     }
@@ -23,46 +36,520 @@ namespace Hazel
 
     void RendererSystem::OnUpdate(Timestep ts)
     {
-        for (const Entity e : m_Entities)
+        // render
+        // quads with a world matrix cached by the TransformPropagationSystem
+        m_ECS->View<const WorldTransform, const Colored, const Drawable>(Exclude<Textured>{}).Each(
+            [](const WorldTransform& world, const Colored& colored, const Drawable& drawable)
+            {
+                if (drawable.GeometryType == PrimitiveGeometryType::Quad)
+                {
+                    Renderer2D::DrawQuad(world.Matrix, colored.Color);
+                }
+            });
+        m_ECS->View<const WorldTransform, const Colored, const Drawable, const Textured>().Each(
+            [](const WorldTransform& world, const Colored& colored, const Drawable& drawable,
+               const Textured& textureData)
+            {
+                if (drawable.GeometryType == PrimitiveGeometryType::Quad)
+                {
+                    Renderer2D::DrawQuad(world.Matrix, textureData.Texture, textureData.TilingFactor, colored.Color);
+                }
+            });
+
+        // quads without a world matrix come from the Transform, Colored and Drawable group, which
+        // is read side by side: only the optional components are probed
+        const auto worlds = m_ECS->View<const WorldTransform>();
+        const auto textures = m_ECS->View<const Textured>();
+
+        // Drawn far to near, and quads at the same depth sharing a texture one after another. The
+        // group is iterated back to front, so the keys descend with the depth. The order barely
+        // changes between frames, re-sorting is close to linear. Untextured quads get texture 0,
+        // the invalid shared index wraps around to it.
+        m_ECS->SortByKey<Transform>([&textures](Entity entity, ColumnRef<const Transform> transform)
         {
-            // render
-            // quads
-            const auto& transform = m_ECS->GetComponent<Transform>(e);
-            const auto& color = m_ECS->GetComponent<Colored>(e).Color;
-            auto type = m_ECS->GetComponent<Drawable>(e).GeometryType;
-            if (type == PrimitiveGeometryType::Quad)
+            const SharedIndex texture = textures.SharedIndexOf<const Textured>(entity) + 1;
+            return static_cast<uint64_t>(~SortableDepth(transform.Get<&Transform::Position>().z)) << 32 | texture;
+        });
+
+        const auto quads = m_ECS->Group<const Transform, const Colored, const Drawable>();
+        quads.Each([&](Entity entity, const Transform& transform, const Colored& colored, const Drawable& drawable)
+        {
+            if (drawable.GeometryType != PrimitiveGeometryType::Quad || worlds.Contains(entity))
+            {
+                // TODO : triangles
+                return;
+            }
+
+            const Textured* textureData = textures.TryGet<const Textured>(entity);
+            if (!textureData)
             {
                 // has rotation?
                 if (transform.Rotation == 0.0f)
                 {
-                    // has texture?
-                    if (m_ECS->HasComponent<Textured>(e))
-                    {
-                        const auto& textureData = m_ECS->GetComponent<Textured>(e);
-                        Renderer2D::DrawQuad(transform.Position, transform.Size, textureData.Texture,
-                                             textureData.TilingFactor, color);
-                    }
-                    else
-                    {
-                        Renderer2D::DrawQuad(transform.Position, transform.Size, color);
-                    }
+                    Renderer2D::DrawQuad(transform.Position, transform.Size, colored.Color);
                 }
                 else
                 {
-                    // has texture?
-                    if (m_ECS->HasComponent<Textured>(e))
+                    Renderer2D::DrawRotatedQuad(transform.Position, transform.Size, transform.Rotation,
+                                                colored.Color);
+                }
+            }
+            else if (transform.Rotation == 0.0f)
+            {
+                Renderer2D::DrawQuad(transform.Position, transform.Size, textureData->Texture,
+                                     textureData->TilingFactor, colored.Color);
+            }
+            else
+            {
+                Renderer2D::DrawRotatedQuad(transform.Position, transform.Size, transform.Rotation,
+                                            textureData->Texture, textureData->TilingFactor, colored.Color);
+            }
+        });
+    }
+
+    // -----------------------------------------------------------------
+    // Physics System
+    // -----------------------------------------------------------------
+    namespace
+    {
+        // Bodies gathered into SoA arrays, all x coordinates first, then y, then z
+        class PhysicsBatch
+        {
+        public:
+            static constexpr unsigned CAPACITY = 256;
+
+            void Add(glm::vec3& position, glm::vec3& velocity, const glm::vec3& acceleration)
+            {
+                for (unsigned axis = 0; axis < 3; ++axis)
+                {
+                    m_Positions[axis * CAPACITY + m_Count] = position[axis];
+                    m_Velocities[axis * CAPACITY + m_Count] = velocity[axis];
+                    m_Accelerations[axis * CAPACITY + m_Count] = acceleration[axis];
+                }
+                m_PositionTargets[m_Count] = &position;
+                m_VelocityTargets[m_Count] = &velocity;
+                ++m_Count;
+            }
+
+            bool Full() const
+            {
+                return m_Count == CAPACITY;
+            }
+
+            // Integrates the gathered bodies and writes them back
+            void Flush(Integrator integrator, float dt, unsigned substeps)
+            {
+                const unsigned count = (m_Count + PHYSICS_KERNEL_WIDTH - 1) / PHYSICS_KERNEL_WIDTH * PHYSICS_KERNEL_WIDTH;
+                for (unsigned axis = 0; axis < 3; ++axis)
+                {
+                    IntegrateCoordinates(integrator, m_Positions + axis * CAPACITY, m_Velocities + axis * CAPACITY,
+                                         m_Accelerations + axis * CAPACITY, count, dt, substeps);
+                }
+                for (unsigned i = 0; i < m_Count; ++i)
+                {
+                    for (unsigned axis = 0; axis < 3; ++axis)
                     {
-                        const auto& textureData = m_ECS->GetComponent<Textured>(e);
-                        Renderer2D::DrawRotatedQuad(transform.Position, transform.Size, transform.Rotation,
-                                                    textureData.Texture, textureData.TilingFactor, color);
+                        (*m_PositionTargets[i])[axis] = m_Positions[axis * CAPACITY + i];
+                        (*m_VelocityTargets[i])[axis] = m_Velocities[axis * CAPACITY + i];
                     }
-                    else
+                }
+                m_Count = 0;
+            }
+
+        private:
+            // Lanes past the count are integrated too and ignored, they start out as zeros
+            alignas(32) float m_Positions[3 * CAPACITY] = {};
+            alignas(32) float m_Velocities[3 * CAPACITY] = {};
+            alignas(32) float m_Accelerations[3 * CAPACITY] = {};
+
+            // Where the gathered coordinates are written back to, in the component columns
+            glm::vec3* m_PositionTargets[CAPACITY];
+            glm::vec3* m_VelocityTargets[CAPACITY];
+            unsigned m_Count = 0;
+        };
+    }
+
+    PhysicsSystem::PhysicsSystem(ECS* ecs) : System(ecs)
+    {
+    }
+
+    Ref<System> PhysicsSystem::Clone() const
+    {
+        return std::static_pointer_cast<System>(std::make_shared<PhysicsSystem>(*this));
+    }
+
+    void PhysicsSystem::OnUpdate(Timestep ts)
+    {
+        HZ_PROFILE_FUNCTION();
+
+        m_Accumulator += ts;
+        unsigned substeps = static_cast<unsigned>(m_Accumulator / m_FixedTimestep);
+        if (substeps > m_MaxSubsteps)
+        {
+            substeps = m_MaxSubsteps;
+            m_Accumulator = 0.0f;
+        }
+        else
+        {
+            m_Accumulator -= substeps * m_FixedTimestep;
+        }
+        if (substeps == 0)
+        {
+            return;
+        }
+
+        const Integrator integrator = m_Integrator;
+        const float dt = m_FixedTimestep;
+
+        // Gravity is optional, it is probed instead of splitting the bodies into two joins
+        const auto gravities = m_ECS->View<const Gravity>();
+
+        // Bodies are read first and only those that move are fetched for writing, so that static
+        // and resting ones are not stamped as changed
+        const auto writable = m_ECS->View<Transform, RigidBody>();
+        writable.MakeWritablePoolsUnique();
+        m_ECS->View<const RigidBody, const Transform>().ParallelChunks([=, &gravities, &writable](auto&& each)
+        {
+            PhysicsBatch batch;
+            each([&](Entity entity, ColumnRef<const RigidBody> body, ColumnRef<const Transform>)
+            {
+                if (!body.Get<&RigidBody::Movable>())
+                {
+                    return;
+                }
+
+                // Only the columns the integration needs are touched
+                glm::vec3 acceleration = body.Get<&RigidBody::Acceleration>();
+                const float mass = body.Get<&RigidBody::Mass>();
+                const Gravity* gravity = gravities.TryGet<const Gravity>(entity);
+                if (gravity && mass > 0.0f)
+                {
+                    acceleration += gravity->Force / mass;
+                }
+                if (acceleration == glm::vec3(0.0f) && body.Get<&RigidBody::Velocity>() == glm::vec3(0.0f))
+                {
+                    return;
+                }
+
+                batch.Add(writable.Get<Transform>(entity).Get<&Transform::Position>(),
+                          writable.Get<RigidBody>(entity).Get<&RigidBody::Velocity>(), acceleration);
+                if (batch.Full())
+                {
+                    batch.Flush(integrator, dt, substeps);
+                }
+            });
+            batch.Flush(integrator, dt, substeps);
+        });
+    }
+
+    // -----------------------------------------------------------------
+    // Transform Propagation System
+    // -----------------------------------------------------------------
+    TransformPropagationSystem::TransformPropagationSystem(ECS* ecs) : System(ecs)
+    {
+    }
+
+    // Copies start without the order and matrices, they are rebuilt on the first update
+    Ref<System> TransformPropagationSystem::Clone() const
+    {
+        const Ref<TransformPropagationSystem> clone = std::make_shared<TransformPropagationSystem>(m_ECS);
+        static_cast<System&>(*clone) = *this;
+        return clone;
+    }
+
+    void TransformPropagationSystem::OnUpdate(Timestep ts)
+    {
+        HZ_PROFILE_FUNCTION();
+
+        // Reparenting reorders the members
+        bool reorder = m_OrderDirty;
+        m_ECS->View<const Parent>().Where(Changed<Parent>{m_LastRunTick}).Each([&reorder](const Parent&)
+        {
+            reorder = true;
+        });
+
+        if (reorder)
+        {
+            RebuildOrder();
+            m_Dirty.assign(m_Order.size(), 1);
+        }
+        else
+        {
+            m_Dirty.assign(m_Order.size(), 0);
+            m_ECS->View<const Transform>().Where(Changed<Transform>{m_LastRunTick}).Each(
+                [this](Entity entity, const Transform&)
+                {
+                    const unsigned index = EntityIndex(entity);
+                    if (index < m_Positions.size() && m_Positions[index] < m_Order.size() &&
+                        m_Order[m_Positions[index]] == entity)
                     {
-                        Renderer2D::DrawRotatedQuad(transform.Position, transform.Size, transform.Rotation, color);
+                        m_Dirty[m_Positions[index]] = 1;
                     }
+                });
+        }
+
+        for (size_t i = 0; i < m_Order.size(); ++i)
+        {
+            // Parents come first, their flag is final by now
+            const unsigned parent = m_Parents[i];
+            if (parent != NO_PARENT && m_Dirty[parent])
+            {
+                m_Dirty[i] = 1;
+            }
+            if (!m_Dirty[i])
+            {
+                continue;
+            }
+
+            // translate * rotate about z, written out
+            const Transform transform = m_ECS->GetComponent<const Transform>(m_Order[i]);
+            const float radians = glm::radians(transform.Rotation);
+            const float cosine = std::cos(radians);
+            const float sine = std::sin(radians);
+            glm::mat4 local(1.0f);
+            local[0] = {cosine, sine, 0.0f, 0.0f};
+            local[1] = {-sine, cosine, 0.0f, 0.0f};
+            local[3] = {transform.Position, 1.0f};
+            m_World[i] = parent != NO_PARENT ? m_World[parent] * local : local;
+
+            glm::mat4& matrix = m_ECS->GetComponent<WorldTransform>(m_Order[i]).Matrix;
+            matrix = m_World[i];
+            matrix[0] *= transform.Size.x;
+            matrix[1] *= transform.Size.y;
+        }
+    }
+
+    void TransformPropagationSystem::OnEntityAdded(Entity e)
+    {
+        m_OrderDirty = true;
+    }
+
+    void TransformPropagationSystem::OnEntityRemoved(Entity e)
+    {
+        m_OrderDirty = true;
+    }
+
+    void TransformPropagationSystem::OnWorldReset()
+    {
+        m_OrderDirty = true;
+    }
+
+    void TransformPropagationSystem::RebuildOrder()
+    {
+        HZ_PROFILE_FUNCTION();
+
+        const size_t count = m_Entities.Size();
+        std::vector<Entity> members(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            members[i] = m_Entities[static_cast<unsigned>(i)];
+            const unsigned index = EntityIndex(members[i]);
+            if (index >= m_Positions.size())
+            {
+                m_Positions.resize(index + 1, NO_PARENT);
+            }
+            m_Positions[index] = static_cast<unsigned>(i);
+        }
+
+        // Parents that are not members, e.g. destroyed ones, leave their children as roots
+        std::vector<unsigned> parents(count, NO_PARENT);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!m_ECS->HasComponent<Parent>(members[i]))
+            {
+                continue;
+            }
+            const Entity parent = m_ECS->GetComponent<const Parent>(members[i]).Handle;
+            const unsigned index = EntityIndex(parent);
+            if (parent != NULL_ENTITY && index < m_Positions.size() && m_Positions[index] < count &&
+                members[m_Positions[index]] == parent)
+            {
+                parents[i] = m_Positions[index];
+            }
+        }
+
+        // Depth of every member, walking up to the nearest ancestor of known depth
+        constexpr unsigned UNKNOWN = ~0u;
+        std::vector<unsigned> depths(count, UNKNOWN);
+        std::vector<unsigned> path;
+        unsigned maxDepth = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            unsigned member = static_cast<unsigned>(i);
+            while (member != NO_PARENT && depths[member] == UNKNOWN)
+            {
+                path.push_back(member);
+                member = parents[member];
+                HZ_CORE_ASSERT(path.size() <= count, "The hierarchy has a cycle.");
+            }
+            unsigned depth = member == NO_PARENT ? 0 : depths[member] + 1;
+            for (auto it = path.rbegin(); it != path.rend(); ++it)
+            {
+                depths[*it] = depth++;
+            }
+            if (!path.empty())
+            {
+                maxDepth = std::max(maxDepth, depth - 1);
+            }
+            path.clear();
+        }
+
+        // Counting sort by depth, stable within a depth
+        std::vector<unsigned> starts(maxDepth + 2, 0);
+        for (const unsigned depth : depths)
+        {
+            ++starts[depth + 1];
+        }
+        for (size_t depth = 1; depth < starts.size(); ++depth)
+        {
+            starts[depth] += starts[depth - 1];
+        }
+        std::vector<unsigned> sorted(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            sorted[starts[depths[i]]++] = static_cast<unsigned>(i);
+        }
+
+        m_Order.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_Order[i] = members[sorted[i]];
+            m_Positions[EntityIndex(m_Order[i])] = static_cast<unsigned>(i);
+        }
+        m_Parents.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const unsigned parent = parents[sorted[i]];
+            m_Parents[i] = parent == NO_PARENT ? NO_PARENT : m_Positions[EntityIndex(members[parent])];
+        }
+        m_World.resize(count);
+        m_OrderDirty = false;
+    }
+
+    // -----------------------------------------------------------------
+    // Spatial Index System
+    // -----------------------------------------------------------------
+    SpatialIndexSystem::SpatialIndexSystem(ECS* ecs) : System(ecs)
+    {
+    }
+
+    // Copies start with an empty index, it is rebuilt on the first update
+    Ref<System> SpatialIndexSystem::Clone() const
+    {
+        const Ref<SpatialIndexSystem> clone = std::make_shared<SpatialIndexSystem>(m_ECS);
+        static_cast<System&>(*clone) = *this;
+        return clone;
+    }
+
+    void SpatialIndexSystem::OnUpdate(Timestep ts)
+    {
+        HZ_PROFILE_FUNCTION();
+
+        m_Changed.clear();
+        m_ECS->View<const Transform>().Where(Changed<Transform>{m_LastRunTick}).Each(
+            [this](Entity entity, const Transform& transform)
+            {
+                m_Changed.push_back({entity, TransformBounds(transform)});
+            });
+        m_Index.UpdateBatch(m_Changed);
+    }
+
+    void SpatialIndexSystem::OnEntityRemoved(Entity e)
+    {
+        m_Index.Remove(e);
+    }
+
+    void SpatialIndexSystem::OnWorldReset()
+    {
+        HZ_PROFILE_FUNCTION();
+
+        m_Changed.clear();
+        for (const Entity entity : m_Entities)
+        {
+            m_Changed.push_back({entity, TransformBounds(m_ECS->GetComponent<const Transform>(entity))});
+        }
+        m_Index.Clear();
+        m_Index.UpdateBatch(m_Changed);
+    }
+
+    // -----------------------------------------------------------------
+    // Broadphase System
+    // -----------------------------------------------------------------
+    BroadphaseSystem::BroadphaseSystem(ECS* ecs) : System(ecs)
+    {
+    }
+
+    // Copies start without bounds, they are rebuilt on the first update. The last reported overlaps
+    // are kept, so that a restored world ends the contacts it no longer has.
+    Ref<System> BroadphaseSystem::Clone() const
+    {
+        const Ref<BroadphaseSystem> clone = std::make_shared<BroadphaseSystem>(m_ECS);
+        static_cast<System&>(*clone) = *this;
+        clone->m_PreviousPairs = m_PreviousPairs;
+        return clone;
+    }
+
+    void BroadphaseSystem::OnUpdate(Timestep ts)
+    {
+        HZ_PROFILE_FUNCTION();
+
+        m_ECS->View<const Transform>().Where(Changed<Transform>{m_LastRunTick}).Each(
+            [this](Entity entity, const Transform& transform)
+            {
+                if (m_Broadphase.Contains(entity))
+                {
+                    m_Broadphase.Update(entity, TransformBounds(transform));
                 }
+            });
+
+        m_Broadphase.FindPairs(m_Pairs);
+
+        // Both lists are sorted, one merge tells the new, kept and lost pairs apart
+        m_Events.clear();
+        size_t current = 0;
+        size_t previous = 0;
+        while (current < m_Pairs.size() || previous < m_PreviousPairs.size())
+        {
+            if (previous == m_PreviousPairs.size() ||
+                (current < m_Pairs.size() && m_Pairs[current].Key() < m_PreviousPairs[previous].Key()))
+            {
+                const OverlapPair& pair = m_Pairs[current++];
+                m_Events.push_back({pair.A, pair.B, ContactState::Begin});
+            }
+            else if (current == m_Pairs.size() || m_PreviousPairs[previous].Key() < m_Pairs[current].Key())
+            {
+                const OverlapPair& pair = m_PreviousPairs[previous++];
+                m_Events.push_back({pair.A, pair.B, ContactState::End});
+            }
+            else
+            {
+                const OverlapPair& pair = m_Pairs[current++];
+                ++previous;
+                m_Events.push_back({pair.A, pair.B, ContactState::Stay});
             }
-            // TODO : triangles
+        }
+        std::swap(m_Pairs, m_PreviousPairs);
+    }
+
+    void BroadphaseSystem::OnEntityAdded(Entity e)
+    {
+        m_Broadphase.Insert(e, TransformBounds(m_ECS->GetComponent<const Transform>(e)));
+    }
+
+    void BroadphaseSystem::OnEntityRemoved(Entity e)
+    {
+        m_Broadphase.Remove(e);
+    }
+
+    // The previous pairs stay, so that the next update ends the contacts the new world lacks
+    void BroadphaseSystem::OnWorldReset()
+    {
+        HZ_PROFILE_FUNCTION();
+
+        m_Broadphase.Clear();
+        for (const Entity entity : m_Entities)
+        {
+            m_Broadphase.Insert(entity, TransformBounds(m_ECS->GetComponent<const Transform>(entity)));
         }
     }
 }
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "Broadphase.h"
 #include "ECSTypeDefs.h"
+#include "EntitySet.h"
+#include "PhysicsKernels.h"
+#include "SpatialIndex.h"
 #include "Hazel/Core/Timestep.h"
-#include <set>
+#include "Hazel/Renderer/OrthographicCamera.h"
 
 #include "Hazel/Events/Event.h"
 
@@ -10,6 +14,26 @@ namespace Hazel
 {
     class ECS;
 
+    // What a system touches during OnUpdate, declared through ECS::SetSystemAccess. The scheduler runs
+    // systems whose accesses do not conflict at the same time. Systems that never declared their
+    // access are exclusive: they run alone, on the main thread, and may make structural changes.
+    struct SystemAccess
+    {
+        Signature Reads;
+        Signature Writes;
+
+        // For systems that use thread-affine engine state, e.g. the renderer
+        bool MainThreadOnly = false;
+
+        bool Exclusive = true;
+
+        bool ConflictsWith(const SystemAccess& other) const
+        {
+            return Exclusive || other.Exclusive ||
+                (Writes & (other.Reads | other.Writes)).any() || (other.Writes & Reads).any();
+        }
+    };
+
     class System
     {
     public:
@@ -34,13 +58,30 @@ namespace Hazel
         {
         }
 
+        // Called before the next update once the world's entities and components were replaced
+        // without the notifications above, by ECS::Revert, by assigning a world or by loading one.
+        // Anything the system derived from the world must be rebuilt from scratch.
+        virtual void OnWorldReset()
+        {
+        }
+
     public:
-        std::set<Entity> m_Entities;
+        // Entities matching the system signature, a packed sparse set with contiguous iteration
+        EntitySet m_Entities;
     protected:
         ECS* m_ECS;
+
+        // Change tick of the previous OnUpdate, 0 before the first. Pass it to the Changed and
+        // Added view filters to visit only what changed since, e.g. Changed<Transform>{m_LastRunTick}.
+        ChangeTick m_LastRunTick = 0;
+
+        // World epoch the system last saw, see SystemManager::ResetWorld()
+        unsigned m_Epoch = 0;
+
+        friend class SystemManager;
     };
 
-    // wrapper for the existing 2d renderer
+    // wrapper for the existing 2d renderer, needs the Transform, Colored and Drawable group
     class RendererSystem : public System
     {
     public:
@@ -52,4 +93,165 @@ namespace Hazel
 
         void OnUpdate(Timestep ts) override;
     };
+
+    // Integrates the RigidBody and Transform of movable bodies on a fixed timestep. Accelerations are
+    // RigidBody::Acceleration plus Gravity::Force / Mass for bodies with Gravity and held constant
+    // over the substeps of a frame. Bodies are gathered into SoA batches for SIMD kernels, chunks of
+    // them in parallel. Only bodies that move are written, static and resting ones are not changed.
+    class PhysicsSystem : public System
+    {
+    public:
+        explicit PhysicsSystem(ECS* ecs);
+
+        Ref<System> Clone() const override;
+
+        ~PhysicsSystem() override = default;
+
+        void OnUpdate(Timestep ts) override;
+
+        void SetIntegrator(Integrator integrator)
+        {
+            m_Integrator = integrator;
+        }
+
+        void SetFixedTimestep(float seconds)
+        {
+            m_FixedTimestep = seconds;
+        }
+
+        // Frames that would need more substeps drop the excess time instead of falling further behind
+        void SetMaxSubsteps(unsigned substeps)
+        {
+            m_MaxSubsteps = substeps;
+        }
+
+    private:
+        Integrator m_Integrator = Integrator::SemiImplicitEuler;
+        float m_FixedTimestep = 1.0f / 120.0f;
+        unsigned m_MaxSubsteps = 8;
+
+        // Simulation time not consumed by a substep yet
+        float m_Accumulator = 0.0f;
+    };
+
+    // Caches the world matrix of every entity with a Transform and a WorldTransform. Members are kept
+    // in breadth-first order, parents before their children, so one pass computes every matrix from
+    // that of the parent. Only subtrees below a transform changed since the previous update are
+    // recomputed, so Transform and Parent need change tracking.
+    class TransformPropagationSystem : public System
+    {
+    public:
+        explicit TransformPropagationSystem(ECS* ecs);
+
+        Ref<System> Clone() const override;
+
+        ~TransformPropagationSystem() override = default;
+
+        void OnUpdate(Timestep ts) override;
+
+        void OnEntityAdded(Entity e) override;
+
+        void OnEntityRemoved(Entity e) override;
+
+        void OnWorldReset() override;
+
+    private:
+        static constexpr unsigned NO_PARENT = ~0u;
+
+        // Sorts the members by depth and links them to their parents
+        void RebuildOrder();
+
+        // Members by depth, roots first
+        std::vector<Entity> m_Order;
+
+        // Position of the parent in m_Order for every member, NO_PARENT for roots
+        std::vector<unsigned> m_Parents;
+
+        // World matrix of every member without its size, what its children build on
+        std::vector<glm::mat4> m_World;
+
+        // Members recomputed by the current update
+        std::vector<unsigned char> m_Dirty;
+
+        // Position in m_Order, indexed by entity slot
+        std::vector<unsigned> m_Positions;
+
+        bool m_OrderDirty = true;
+    };
+
+    // Keeps a SpatialIndex of the bounds of every Transform. Only transforms that changed since the
+    // previous update are re-indexed, so Transform needs change tracking. A reset world is
+    // re-indexed whole.
+    class SpatialIndexSystem : public System
+    {
+    public:
+        explicit SpatialIndexSystem(ECS* ecs);
+
+        Ref<System> Clone() const override;
+
+        ~SpatialIndexSystem() override = default;
+
+        void OnUpdate(Timestep ts) override;
+
+        void OnEntityRemoved(Entity e) override;
+
+        void OnWorldReset() override;
+
+        // Reflects the transforms as of the last OnUpdate
+        const SpatialIndex& GetIndex() const
+        {
+            return m_Index;
+        }
+
+        // Calls func(entry) for the entities that may be visible through the camera
+        template <typename Func>
+        void QueryVisible(const OrthographicCamera& camera, Func func) const
+        {
+            m_Index.Query(camera.GetWorldBounds(), func);
+        }
+
+    private:
+        SpatialIndex m_Index;
+
+        // Changed transforms of the current update, kept for its capacity
+        std::vector<SpatialEntry> m_Changed;
+    };
+
+    // Finds the entities whose Transform bounds overlap with a SweepAndPrune and reports every
+    // overlapping pair once per update, as beginning, staying or ending. Only transforms that
+    // changed since the previous update are refreshed, so Transform needs change tracking.
+    // Systems consuming the events must run in a later stage, e.g. by writing Transform.
+    class BroadphaseSystem : public System
+    {
+    public:
+        explicit BroadphaseSystem(ECS* ecs);
+
+        Ref<System> Clone() const override;
+
+        ~BroadphaseSystem() override = default;
+
+        void OnUpdate(Timestep ts) override;
+
+        void OnEntityAdded(Entity e) override;
+
+        void OnEntityRemoved(Entity e) override;
+
+        void OnWorldReset() override;
+
+        // Events of the last OnUpdate, sorted by pair
+        const std::vector<ContactEvent>& GetContactEvents() const
+        {
+            return m_Events;
+        }
+
+    private:
+        SweepAndPrune m_Broadphase;
+
+        // Overlaps of the current and the previous update, sorted by key
+        std::vector<OverlapPair> m_Pairs;
+        std::vector<OverlapPair> m_PreviousPairs;
+
+        // Refilled by every update, keeping its capacity
+        std::vector<ContactEvent> m_Events;
+    };
 }
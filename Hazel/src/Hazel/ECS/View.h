@@ -0,0 +1,499 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ComponentArray.h"
+#include "ECSTypeDefs.h"
+#include "Hazel/Core/ThreadPool.h"
+
+namespace Hazel
+{
+    // Component types an entity must not have to show up in a view, e.g. View<Transform>(Exclude<Textured>{})
+    template <typename... Ts>
+    struct Exclude
+    {
+    };
+
+    // Keeps entities whose Ts components were added or written through a mutable accessor after the
+    // tick Since, e.g. View<const Transform>().Where(Changed<Transform>{m_LastRunTick}) in a system.
+    // Ts must be included in the view and have change tracking enabled.
+    template <typename... Ts>
+    struct Changed
+    {
+        ChangeTick Since;
+    };
+
+    // Keeps entities that received their Ts components after the tick Since
+    template <typename... Ts>
+    struct Added
+    {
+        ChangeTick Since;
+    };
+
+    template <typename ExcludeList, typename... Includes>
+    class ComponentView;
+
+    // Joins several component pools. Iteration walks the smallest pool densely and only probes the
+    // others, handing out references to every requested component in one pass. Components requested
+    // as const are handed out as const references. Disabled entities are left out, and not even
+    // visited, unless the view includes Disabled or IncludeDisabled() is used.
+    template <typename... Excludes, typename... Includes>
+    class ComponentView<Exclude<Excludes...>, Includes...>
+    {
+        static_assert(sizeof...(Includes) > 0, "A view needs at least one component type.");
+
+    public:
+        // Chunk boundaries of parallel iteration are multiples of this many packed entries, so that
+        // two chunks never share a cache line of any pool
+        static constexpr unsigned CHUNK_GRANULARITY = static_cast<unsigned>(CACHE_LINE_SIZE);
+
+        ComponentView(ComponentArray<std::remove_const_t<Includes>>*... pools, ComponentArray<Excludes>*... excludes)
+            : m_Pools(pools...), m_Excludes(excludes...),
+              m_IncludeDisabled((std::is_same_v<std::remove_const_t<Includes>, Disabled> || ...))
+        {
+        }
+
+        // Calls func(entity, components...) or func(components...) for every matching entity.
+        // Iterates back to front, so the current entity may safely lose its components inside func.
+        template <typename Func>
+        void Each(Func func) const
+        {
+            const size_t driver = SmallestPool();
+            EachInRange(driver, 0, PoolSize(driver), [&func](Entity entity, ComponentReference<Includes>... components)
+            {
+                Invoke(func, entity, components...);
+            });
+        }
+
+        // Like Each, but splits the driving pool into chunks that run on the shared thread pool.
+        // func is called concurrently for different entities and must only touch their components.
+        template <typename Func>
+        void ParallelEach(Func func) const
+        {
+            const size_t driver = SmallestPool();
+            const unsigned size = PoolSize(driver);
+            const unsigned chunkSize = ChunkSize(size);
+            const unsigned chunkCount = (size + chunkSize - 1) / chunkSize;
+
+            MakeWritablePoolsUnique();
+            ThreadPool::Get().ParallelFor(chunkCount, [&](unsigned chunk)
+            {
+                const unsigned begin = chunk * chunkSize;
+                EachInRange(driver, begin, std::min(size, begin + chunkSize), [&func](Entity entity, ComponentReference<Includes>... components)
+                {
+                    Invoke(func, entity, components...);
+                });
+            });
+        }
+
+        // Like ParallelEach, but hands every chunk to func as a whole: func(each), where each(f) calls
+        // f([entity,] components...) for the chunk's matching entities. Lets func batch the chunk,
+        // e.g. gather it into arrays for SIMD kernels, and flush once the chunk is done.
+        template <typename Func>
+        void ParallelChunks(Func func) const
+        {
+            const size_t driver = SmallestPool();
+            const unsigned size = PoolSize(driver);
+            const unsigned chunkSize = ChunkSize(size);
+            const unsigned chunkCount = (size + chunkSize - 1) / chunkSize;
+
+            MakeWritablePoolsUnique();
+            ThreadPool::Get().ParallelFor(chunkCount, [&](unsigned chunk)
+            {
+                const unsigned begin = chunk * chunkSize;
+                func([&](auto&& f)
+                {
+                    EachInRange(driver, begin, std::min(size, begin + chunkSize), [&f](Entity entity, ComponentReference<Includes>... components)
+                    {
+                        Invoke(f, entity, components...);
+                    });
+                });
+            });
+        }
+
+        // Parallel iteration with scratch state: every chunk starts from a copy of identity and
+        // accumulates through func(state, [entity,] components...). The chunk states are then folded
+        // into the result with reduce(result, chunkState) in chunk order, so the outcome does not
+        // depend on the number of threads or on which thread ran which chunk.
+        template <typename State, typename Func, typename Reduce>
+        State ParallelReduce(const State& identity, Func func, Reduce reduce) const
+        {
+            const size_t driver = SmallestPool();
+            const unsigned size = PoolSize(driver);
+            const unsigned chunkSize = ChunkSize(size);
+            const unsigned chunkCount = (size + chunkSize - 1) / chunkSize;
+
+            std::vector<State> chunkStates(chunkCount, identity);
+            MakeWritablePoolsUnique();
+            ThreadPool::Get().ParallelFor(chunkCount, [&](unsigned chunk)
+            {
+                State& state = chunkStates[chunk];
+                const unsigned begin = chunk * chunkSize;
+                EachInRange(driver, begin, std::min(size, begin + chunkSize), [&func, &state](Entity entity, ComponentReference<Includes>... components)
+                {
+                    if constexpr (std::is_invocable_v<Func&, State&, Entity, ComponentReference<Includes>...>)
+                    {
+                        func(state, entity, components...);
+                    }
+                    else
+                    {
+                        func(state, components...);
+                    }
+                });
+            });
+
+            State result = identity;
+            for (const State& state : chunkStates)
+            {
+                reduce(result, state);
+            }
+            return result;
+        }
+
+        // Hands the components to func(chunk) as ColumnChunks of up to CHUNK_SIZE consecutive
+        // components each, for kernels over whole arrays. Only for views of a single columnar
+        // component without filters, so that the chunks cover the view exactly. func must not make
+        // structural changes.
+        template <typename Func>
+        void EachColumnChunk(Func func) const
+        {
+            AssertColumnChunks();
+            constexpr unsigned chunkSize = ComponentArray<std::remove_const_t<Includes>...>::CHUNK_SIZE;
+            const unsigned size = PoolSize(*std::get<0>(m_Pools));
+            for (unsigned begin = 0; begin < size; begin += chunkSize)
+            {
+                func(FetchChunk(begin, std::min(chunkSize, size - begin)));
+            }
+        }
+
+        // Like EachColumnChunk, but the chunks run on the shared thread pool
+        template <typename Func>
+        void ParallelColumnChunks(Func func) const
+        {
+            AssertColumnChunks();
+            constexpr unsigned chunkSize = ComponentArray<std::remove_const_t<Includes>...>::CHUNK_SIZE;
+            const unsigned size = PoolSize(*std::get<0>(m_Pools));
+            const unsigned chunkCount = (size + chunkSize - 1) / chunkSize;
+
+            MakeWritablePoolsUnique();
+            ThreadPool::Get().ParallelFor(chunkCount, [&](unsigned chunk)
+            {
+                const unsigned begin = chunk * chunkSize;
+                func(FetchChunk(begin, std::min(chunkSize, size - begin)));
+            });
+        }
+
+        // Copy of the view that also applies the given Changed and Added filters
+        template <typename... Filters>
+        ComponentView Where(Filters... filters) const
+        {
+            ComponentView view = *this;
+            (view.AddFilter(filters), ...);
+            return view;
+        }
+
+        // Copy of the view that visits disabled entities too, e.g. for tools that list every entity
+        ComponentView IncludeDisabled() const
+        {
+            ComponentView view = *this;
+            view.m_IncludeDisabled = true;
+            return view;
+        }
+
+        bool Contains(Entity entity) const
+        {
+            // An entity is enabled in all of its pools or in none, the first one tells
+            const PackedIndexArray indices = PackedIndices(entity, std::index_sequence_for<Includes...>{});
+            return Matches(entity, indices) && (m_IncludeDisabled || indices[0] < std::get<0>(m_Pools)->ActiveSize());
+        }
+
+        template <typename T>
+        ComponentReference<T> Get(Entity entity) const
+        {
+            auto* pool = std::get<ComponentArray<std::remove_const_t<T>>*>(m_Pools);
+            if constexpr (std::is_const_v<T>)
+            {
+                return std::as_const(*pool).GetData(entity);
+            }
+            else
+            {
+                return pool->GetData(entity);
+            }
+        }
+
+        // The entity's component, or nullptr if it has none
+        template <typename T>
+        T* TryGet(Entity entity) const
+        {
+            auto* pool = std::get<ComponentArray<std::remove_const_t<T>>*>(m_Pools);
+            if constexpr (std::is_const_v<T>)
+            {
+                return std::as_const(*pool).TryGet(entity);
+            }
+            else
+            {
+                return pool->TryGet(entity);
+            }
+        }
+
+        // Index of the entity's value among the distinct values of the shared component type T,
+        // INVALID_SHARED_INDEX if it has none
+        template <typename T>
+        SharedIndex SharedIndexOf(Entity entity) const
+        {
+            const auto* pool = std::get<ComponentArray<std::remove_const_t<T>>*>(m_Pools);
+            const unsigned packedIndex = pool->IndexOf(entity);
+            return packedIndex != EntitySet::INVALID_INDEX ? pool->SharedIndexAt(packedIndex) : INVALID_SHARED_INDEX;
+        }
+
+        // Upper bound on the number of entities visited, the size of the smallest pool
+        unsigned SizeHint() const
+        {
+            return PoolSize(SmallestPool());
+        }
+
+        // Clones the pages that written pools still share with a snapshot up front, page
+        // ownership is not thread safe. Parallel iteration does this itself, call it before
+        // writing through Get() from several threads.
+        void MakeWritablePoolsUnique() const
+        {
+            MakeWritablePoolsUnique(std::index_sequence_for<Includes...>{});
+        }
+
+    private:
+        using PackedIndexArray = std::array<unsigned, sizeof...(Includes)>;
+
+        struct TickFilter
+        {
+            bool Changed = false;
+            bool Added = false;
+            ChangeTick ChangedSince = 0;
+            ChangeTick AddedSince = 0;
+        };
+
+        template <typename... Ts>
+        void AddFilter(Changed<Ts...> filter)
+        {
+            (SetTickFilter<Ts>(filter.Since, true), ...);
+        }
+
+        template <typename... Ts>
+        void AddFilter(Added<Ts...> filter)
+        {
+            (SetTickFilter<Ts>(filter.Since, false), ...);
+        }
+
+        template <typename T>
+        void SetTickFilter(ChangeTick since, bool changed)
+        {
+            constexpr size_t index = IncludeIndex<T>();
+            static_assert(index < sizeof...(Includes), "Filtered component types must be included in the view.");
+            HZ_CORE_ASSERT(std::get<index>(m_Pools)->IsTrackingChanges(), "Change tracking is not enabled for a filtered component.");
+
+            TickFilter& filter = m_TickFilters[index];
+            (changed ? filter.Changed : filter.Added) = true;
+            (changed ? filter.ChangedSince : filter.AddedSince) = since;
+            m_HasTickFilters = true;
+        }
+
+        template <typename T>
+        static constexpr size_t IncludeIndex()
+        {
+            constexpr bool matches[] = {std::is_same_v<std::remove_const_t<Includes>, T>...};
+            for (size_t i = 0; i < sizeof...(Includes); ++i)
+            {
+                if (matches[i])
+                {
+                    return i;
+                }
+            }
+            return sizeof...(Includes);
+        }
+
+        template <size_t... I>
+        PackedIndexArray PackedIndices(Entity entity, std::index_sequence<I...>) const
+        {
+            return {std::get<I>(m_Pools)->IndexOf(entity)...};
+        }
+
+        // Whether the entity, found at the given packed indices, passes every include, exclude and
+        // tick filter
+        bool Matches(Entity entity, const PackedIndexArray& indices) const
+        {
+            for (const unsigned index : indices)
+            {
+                if (index == EntitySet::INVALID_INDEX)
+                {
+                    return false;
+                }
+            }
+            return !ContainsAny(entity) &&
+                (!m_HasTickFilters || PassesTickFilters(indices, std::index_sequence_for<Includes...>{}));
+        }
+
+        template <size_t... I>
+        bool PassesTickFilters(const PackedIndexArray& indices, std::index_sequence<I...>) const
+        {
+            return (PassesTickFilter(*std::get<I>(m_Pools), m_TickFilters[I], indices[I]) && ...);
+        }
+
+        template <typename Pool>
+        static bool PassesTickFilter(const Pool& pool, const TickFilter& filter, unsigned index)
+        {
+            return (!filter.Changed || IsNewerTick(pool.ChangedTick(index), filter.ChangedSince)) &&
+                (!filter.Added || IsNewerTick(pool.AddedTick(index), filter.AddedSince));
+        }
+
+        template <typename Func>
+        static void Invoke(Func& func, Entity entity, ComponentReference<Includes>... components)
+        {
+            if constexpr (std::is_invocable_v<Func&, Entity, ComponentReference<Includes>...>)
+            {
+                func(entity, components...);
+            }
+            else
+            {
+                func(components...);
+            }
+        }
+
+        // Aim for a few chunks per thread so that uneven chunks even out
+        static unsigned ChunkSize(unsigned size)
+        {
+            const unsigned target = size / (ThreadPool::Get().GetConcurrency() * 4) + 1;
+            return (target + CHUNK_GRANULARITY - 1) / CHUNK_GRANULARITY * CHUNK_GRANULARITY;
+        }
+
+        size_t SmallestPool() const
+        {
+            return SmallestPool(std::index_sequence_for<Includes...>{});
+        }
+
+        template <size_t... I>
+        size_t SmallestPool(std::index_sequence<I...>) const
+        {
+            size_t driver = 0;
+            unsigned count = ~0u;
+            ((PoolSize(*std::get<I>(m_Pools)) < count ? (count = PoolSize(*std::get<I>(m_Pools)), driver = I) : 0), ...);
+            return driver;
+        }
+
+        unsigned PoolSize(size_t index) const
+        {
+            unsigned size = 0;
+            std::apply([this, &size, index](auto*... pools)
+            {
+                size_t i = 0;
+                ((i++ == index ? (size = PoolSize(*pools), 0) : 0), ...);
+            }, m_Pools);
+            return size;
+        }
+
+        // Entries a view walks in a pool, the disabled ones sit behind the enabled ones
+        template <typename Pool>
+        unsigned PoolSize(const Pool& pool) const
+        {
+            return m_IncludeDisabled ? pool.Size() : pool.ActiveSize();
+        }
+
+        // Calls func(entity, components...) for the matching entities among packed indices
+        // [begin, end) of the driving pool, back to front
+        template <typename Func>
+        void EachInRange(size_t driver, unsigned begin, unsigned end, Func&& func) const
+        {
+            EachDispatch(driver, begin, end, func, std::index_sequence_for<Includes...>{});
+        }
+
+        template <typename Func, size_t... I>
+        void EachDispatch(size_t driver, unsigned begin, unsigned end, Func& func, std::index_sequence<I...>) const
+        {
+            // Pick the loop specialised for the driving pool at run time
+            ((driver == I ? (EachFrom<I>(begin, end, func, std::index_sequence<I...>{}), 0) : 0), ...);
+        }
+
+        template <size_t Driver, typename Func, size_t... I>
+        void EachFrom(unsigned begin, unsigned end, Func& func, std::index_sequence<I...>) const
+        {
+            const auto* driverPool = std::get<Driver>(m_Pools);
+
+            for (unsigned i = end; i-- > begin;)
+            {
+                const Entity entity = driverPool->EntityAt(i);
+
+                // The driving pool is read by packed index, the others are probed once each. The
+                // entity is matched before any component is fetched, fetching a writable one
+                // counts as a write for change tracking.
+                const PackedIndexArray indices{(I == Driver ? i : std::get<I>(m_Pools)->IndexOf(entity))...};
+                if (!Matches(entity, indices))
+                {
+                    continue;
+                }
+
+                func(entity, Fetch<I>(indices[I])...);
+            }
+        }
+
+        // Const components are read through the const pool, so that they never clone a page
+        // shared with a snapshot
+        template <size_t I>
+        decltype(auto) Fetch(unsigned packedIndex) const
+        {
+            using Component = std::tuple_element_t<I, std::tuple<Includes...>>;
+            auto* pool = std::get<I>(m_Pools);
+            if constexpr (std::is_const_v<Component>)
+            {
+                return std::as_const(*pool).At(packedIndex);
+            }
+            else
+            {
+                return pool->At(packedIndex);
+            }
+        }
+
+        void AssertColumnChunks() const
+        {
+            static_assert(sizeof...(Includes) == 1 && sizeof...(Excludes) == 0, "Column chunks are handed out for views of a single component.");
+            static_assert((IsColumnar<Includes>::value && ...), "Column chunks need a component stored in columns.");
+            HZ_CORE_ASSERT(!m_HasTickFilters, "Column chunks cannot apply Changed or Added filters.");
+        }
+
+        auto FetchChunk(unsigned begin, unsigned count) const
+        {
+            auto* pool = std::get<0>(m_Pools);
+            if constexpr ((std::is_const_v<Includes> && ...))
+            {
+                return std::as_const(*pool).ChunkAt(begin, count);
+            }
+            else
+            {
+                return pool->ChunkAt(begin, count);
+            }
+        }
+
+        template <size_t... I>
+        void MakeWritablePoolsUnique(std::index_sequence<I...>) const
+        {
+            ((std::is_const_v<std::tuple_element_t<I, std::tuple<Includes...>>> ? void() : std::get<I>(m_Pools)->MakeUnique()), ...);
+        }
+
+        bool ContainsAny([[maybe_unused]] Entity entity) const
+        {
+            return (std::get<ComponentArray<Excludes>*>(m_Excludes)->Contains(entity) || ...);
+        }
+
+        std::tuple<ComponentArray<std::remove_const_t<Includes>>*...> m_Pools;
+        std::tuple<ComponentArray<Excludes>*...> m_Excludes;
+
+        // Changed and Added filters per include, see Where()
+        std::array<TickFilter, sizeof...(Includes)> m_TickFilters{};
+        bool m_HasTickFilters = false;
+
+        // Whether iteration runs over whole pools rather than their enabled part
+        bool m_IncludeDisabled;
+    };
+}
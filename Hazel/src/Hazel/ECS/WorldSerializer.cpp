@@ -0,0 +1,338 @@
+#include "hzpch.h"
+#include "WorldSerializer.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace Hazel
+{
+    namespace
+    {
+        constexpr uint64_t AlignOffset(uint64_t offset)
+        {
+            return (offset + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+        }
+
+        bool InBounds(uint64_t offset, uint64_t size, size_t fileSize)
+        {
+            return offset % CACHE_LINE_SIZE == 0 && offset <= fileSize && size <= fileSize - offset;
+        }
+
+        uint32_t CountPages(const EntitySet::SparseArray& sparse)
+        {
+            uint32_t count = 0;
+            for (unsigned page = 0; page < sparse.PageCount(); ++page)
+            {
+                count += sparse.PageAt(page) ? 1 : 0;
+            }
+            return count;
+        }
+    }
+
+    WorldSerializer::WorldSerializer()
+    {
+        RegisterComponent<Disabled>("Disabled");
+    }
+
+    void WorldSerializer::AddFormat(ComponentFormat format)
+    {
+        for (const ComponentFormat& existing : m_Formats)
+        {
+            HZ_CORE_ASSERT(existing.NameHash != format.NameHash, "Component name registered more than once.");
+            HZ_CORE_ASSERT(existing.Type != format.Type, "Component type registered more than once.");
+        }
+        m_Formats.push_back(std::move(format));
+    }
+
+    uint64_t WorldSerializer::HashName(const std::string& name)
+    {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (const char c : name)
+        {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    void WorldSerializer::WritePadding(std::ostream& out, size_t bytes)
+    {
+        static const char s_Zeros[4096] = {};
+        while (bytes > 0)
+        {
+            const size_t chunk = std::min(bytes, sizeof(s_Zeros));
+            out.write(s_Zeros, chunk);
+            bytes -= chunk;
+        }
+    }
+
+    bool WorldSerializer::Save(const ECS& ecs, const std::string& path) const
+    {
+        HZ_PROFILE_FUNCTION();
+
+        const EntityManager& entities = ecs.m_EntityManager;
+        const ComponentManager& components = ecs.m_ComponentManager;
+
+        std::vector<const ComponentFormat*> formats;
+        for (const ComponentFormat& format : m_Formats)
+        {
+            if (components.IsRegistered(format.Type))
+            {
+                formats.push_back(&format);
+            }
+        }
+
+        // Lay out every block up front, so that the file is written front to back
+        FileHeader header = {};
+        header.Magic = MAGIC;
+        header.Version = VERSION;
+        header.EntityIndexBits = ENTITY_INDEX_BITS;
+        header.HandlePageSize = EntityManager::PAGE_SIZE;
+        header.EntityPageSize = EntitySet::PACKED_PAGE_SIZE;
+        header.PoolCount = static_cast<uint32_t>(formats.size());
+        header.SlotCount = entities.GetSlotCount();
+        header.LivingEntityCount = entities.GetLivingEntityCount();
+        header.FreeHead = entities.GetFreeHead();
+        header.FreeTail = entities.GetFreeTail();
+
+        uint64_t offset = AlignOffset(sizeof(FileHeader) + formats.size() * sizeof(PoolHeader));
+        header.HandlesOffset = offset;
+        offset = AlignOffset(offset + PaddedCount(header.SlotCount, EntityManager::PAGE_SIZE) * sizeof(Entity));
+        header.SignaturesOffset = offset;
+        offset = AlignOffset(offset + header.SlotCount * sizeof(uint32_t));
+
+        std::vector<PoolHeader> pools(formats.size());
+        for (size_t i = 0; i < formats.size(); ++i)
+        {
+            PoolHeader& pool = pools[i];
+            pool.NameHash = formats[i]->NameHash;
+            pool.ElementSize = formats[i]->ElementSize;
+            pool.PageSize = formats[i]->PageSize;
+            pool.Count = formats[i]->Entities(components).Size();
+            pool.EntitiesOffset = offset;
+            offset = AlignOffset(offset + PaddedCount(pool.Count, EntitySet::PACKED_PAGE_SIZE) * sizeof(Entity));
+            pool.SparsePageCount = CountPages(formats[i]->Entities(components).Sparse());
+            pool.SparsePageIndicesOffset = offset;
+            offset = AlignOffset(offset + pool.SparsePageCount * sizeof(uint32_t));
+            pool.SparsePagesOffset = offset;
+            offset = AlignOffset(offset + pool.SparsePageCount * EntitySet::SPARSE_PAGE_SIZE * sizeof(unsigned));
+            pool.DataOffset = offset;
+            offset = AlignOffset(offset + PaddedCount(pool.Count, pool.PageSize) * pool.ElementSize);
+            pool.ValueSize = formats[i]->ValueSize;
+            pool.ValueCount = formats[i]->ValueCount ? formats[i]->ValueCount(components) : 0;
+            pool.ValuesOffset = offset;
+            offset = AlignOffset(offset + static_cast<uint64_t>(pool.ValueCount) * pool.ValueSize);
+        }
+
+        std::ofstream out(path, std::ios::out | std::ios::binary);
+        if (!out)
+        {
+            HZ_CORE_ERROR("Could not open file '{0}'", path);
+            return false;
+        }
+
+        auto pad = [&out](uint64_t to)
+        {
+            WritePadding(out, static_cast<size_t>(to - static_cast<uint64_t>(out.tellp())));
+        };
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(pools.data()), pools.size() * sizeof(PoolHeader));
+
+        pad(header.HandlesOffset);
+        const auto& handles = entities.Handles();
+        for (unsigned page = 0; page < handles.PageCount(); ++page)
+        {
+            out.write(reinterpret_cast<const char*>(handles.PageAt(page)->Data()), handles.PageAt(page)->Count() * sizeof(Entity));
+        }
+
+        // Signatures are stored with bit i standing for the i-th pool of the file
+        pad(header.SignaturesOffset);
+        std::vector<uint32_t> signatures(header.SlotCount);
+        const auto& entitySignatures = entities.Signatures();
+        for (unsigned slot = 0; slot < header.SlotCount; ++slot)
+        {
+            for (size_t i = 0; i < formats.size(); ++i)
+            {
+                signatures[slot] |= entitySignatures[slot].test(formats[i]->Type) ? 1u << i : 0u;
+            }
+        }
+        out.write(reinterpret_cast<const char*>(signatures.data()), signatures.size() * sizeof(uint32_t));
+
+        for (size_t i = 0; i < formats.size(); ++i)
+        {
+            pad(pools[i].EntitiesOffset);
+            const EntitySet& entitySet = formats[i]->Entities(components);
+            const auto& packed = entitySet.Packed();
+            for (unsigned page = 0; page < packed.PageCount(); ++page)
+            {
+                out.write(reinterpret_cast<const char*>(packed.PageAt(page)->Data()), packed.PageAt(page)->Count() * sizeof(Entity));
+            }
+
+            // Only the allocated pages of the sparse index, preceded by their page numbers
+            const auto& sparse = entitySet.Sparse();
+            pad(pools[i].SparsePageIndicesOffset);
+            for (uint32_t page = 0; page < sparse.PageCount(); ++page)
+            {
+                if (sparse.PageAt(page))
+                {
+                    out.write(reinterpret_cast<const char*>(&page), sizeof(page));
+                }
+            }
+            pad(pools[i].SparsePagesOffset);
+            for (uint32_t page = 0; page < sparse.PageCount(); ++page)
+            {
+                if (sparse.PageAt(page))
+                {
+                    out.write(reinterpret_cast<const char*>(sparse.PageAt(page)->Data()), EntitySet::SPARSE_PAGE_SIZE * sizeof(unsigned));
+                }
+            }
+
+            pad(pools[i].DataOffset);
+            formats[i]->Write(components, out);
+
+            if (formats[i]->WriteValues)
+            {
+                pad(pools[i].ValuesOffset);
+                formats[i]->WriteValues(components, out);
+            }
+        }
+        pad(offset);
+
+        if (!out)
+        {
+            HZ_CORE_ERROR("Could not write file '{0}'", path);
+            return false;
+        }
+        return true;
+    }
+
+    bool WorldSerializer::Load(ECS& ecs, const std::string& path) const
+    {
+        HZ_PROFILE_FUNCTION();
+
+        Ref<MappedFile> file = MappedFile::Open(path);
+        if (!file)
+        {
+            return false;
+        }
+
+        char* data = file->GetData();
+        const size_t size = file->GetSize();
+
+        FileHeader header;
+        if (size < sizeof(FileHeader))
+        {
+            HZ_CORE_ERROR("'{0}' is not a world file", path);
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(FileHeader));
+        if (header.Magic != MAGIC || header.Version != VERSION)
+        {
+            HZ_CORE_ERROR("'{0}' is not a world file of version {1}", path, VERSION);
+            return false;
+        }
+        if (header.EntityIndexBits != ENTITY_INDEX_BITS || header.HandlePageSize != EntityManager::PAGE_SIZE ||
+            header.EntityPageSize != EntitySet::PACKED_PAGE_SIZE)
+        {
+            HZ_CORE_ERROR("'{0}' was written with an incompatible entity layout", path);
+            return false;
+        }
+        if (header.PoolCount > MAX_COMPONENTS || sizeof(FileHeader) + header.PoolCount * sizeof(PoolHeader) > size ||
+            !InBounds(header.HandlesOffset, PaddedCount(header.SlotCount, EntityManager::PAGE_SIZE) * sizeof(Entity), size) ||
+            !InBounds(header.SignaturesOffset, header.SlotCount * sizeof(uint32_t), size))
+        {
+            HZ_CORE_ERROR("'{0}' is truncated", path);
+            return false;
+        }
+
+        // Match the pools of the file with the registered component types
+        std::vector<PoolHeader> pools(header.PoolCount);
+        std::memcpy(pools.data(), data + sizeof(FileHeader), pools.size() * sizeof(PoolHeader));
+        std::vector<const ComponentFormat*> formats(header.PoolCount, nullptr);
+        for (size_t i = 0; i < pools.size(); ++i)
+        {
+            const PoolHeader& pool = pools[i];
+            for (const ComponentFormat& format : m_Formats)
+            {
+                if (format.NameHash == pool.NameHash && ecs.m_ComponentManager.IsRegistered(format.Type))
+                {
+                    formats[i] = &format;
+                }
+            }
+            if (!formats[i])
+            {
+                continue;
+            }
+            if (pool.ElementSize != formats[i]->ElementSize || pool.ValueSize != formats[i]->ValueSize || pool.PageSize == 0 ||
+                !InBounds(pool.EntitiesOffset, PaddedCount(pool.Count, EntitySet::PACKED_PAGE_SIZE) * sizeof(Entity), size) ||
+                !InBounds(pool.SparsePageIndicesOffset, pool.SparsePageCount * sizeof(uint32_t), size) ||
+                !InBounds(pool.SparsePagesOffset, pool.SparsePageCount * EntitySet::SPARSE_PAGE_SIZE * sizeof(unsigned), size) ||
+                !InBounds(pool.DataOffset, PaddedCount(pool.Count, pool.PageSize) * pool.ElementSize, size) ||
+                !InBounds(pool.ValuesOffset, static_cast<uint64_t>(pool.ValueCount) * pool.ValueSize, size))
+            {
+                HZ_CORE_ERROR("Pool '{0}' in '{1}' does not match its registered component", formats[i]->Name, path);
+                return false;
+            }
+            if (formats[i]->Validate && !formats[i]->Validate(pool, data + pool.DataOffset))
+            {
+                HZ_CORE_ERROR("Pool '{0}' in '{1}' is corrupt", formats[i]->Name, path);
+                return false;
+            }
+        }
+
+        // Drop the current world, systems see their entities leave
+        ecs.m_SystemManager.RemoveAllEntities();
+        ecs.m_ComponentManager.Clear();
+
+        Entity* handles = reinterpret_cast<Entity*>(data + header.HandlesOffset);
+        const uint32_t* fileSignatures = reinterpret_cast<const uint32_t*>(data + header.SignaturesOffset);
+        PagedVector<Signature, EntityManager::PAGE_SIZE> signatures;
+        signatures.Reserve(header.SlotCount);
+        for (unsigned slot = 0; slot < header.SlotCount; ++slot)
+        {
+            Signature signature;
+            for (uint32_t i = 0; i < header.PoolCount; ++i)
+            {
+                if ((fileSignatures[slot] >> i & 1u) && formats[i])
+                {
+                    signature.set(formats[i]->Type);
+                }
+            }
+            signatures.EmplaceBack(signature);
+        }
+        ecs.m_EntityManager.Load(PagedVector<Entity, EntityManager::PAGE_SIZE>::Adopt(handles, header.SlotCount, file),
+                                 std::move(signatures), header.FreeHead, header.FreeTail, header.LivingEntityCount);
+
+        for (size_t i = 0; i < pools.size(); ++i)
+        {
+            if (formats[i])
+            {
+                const PoolHeader& pool = pools[i];
+                EntitySet entities;
+                entities.Load(EntitySet::PackedArray::Adopt(reinterpret_cast<Entity*>(data + pool.EntitiesOffset), pool.Count, file),
+                              EntitySet::SparseArray::Adopt(EntitySet::INVALID_INDEX,
+                                                            reinterpret_cast<const uint32_t*>(data + pool.SparsePageIndicesOffset),
+                                                            reinterpret_cast<unsigned*>(data + pool.SparsePagesOffset),
+                                                            pool.SparsePageCount, file));
+                formats[i]->Read(ecs.m_ComponentManager, pool, std::move(entities), data + pool.DataOffset, file);
+            }
+        }
+
+        // Pools are loaded with every entity enabled, the disabled ones move behind the others. Back
+        // to front, so that every entry of the Disabled pool is already in place when it moves.
+        const EntitySet& disabled = ecs.m_ComponentManager.GetComponentArray<Disabled>()->Entities();
+        for (unsigned i = disabled.Size(); i-- > 0;)
+        {
+            const Entity entity = disabled[i];
+            ecs.m_ComponentManager.SetEntityEnabled(entity, ecs.m_EntityManager.GetSignature(entity), false);
+        }
+
+        // Group sizes are not part of the file, the members move to the front of the owned pools again
+        ecs.m_ComponentManager.GroupLivingEntities(ecs.m_EntityManager);
+
+        ecs.m_SystemManager.AddLivingEntities(ecs.m_EntityManager);
+        ecs.m_SystemManager.ResetWorld();
+        return true;
+    }
+}
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Hazel/Core/Core.h"
+#include "Hazel/Core/MappedFile.h"
+#include "ECSCore.h"
+
+namespace Hazel
+{
+    // Saves and loads ECS worlds in a versioned binary format:
+    //   header, pool table, entity handles, entity signatures, then per component pool the owning
+    //   entities, the allocated pages of their sparse index, the components and, for shared
+    //   components, the table of distinct values.
+    // Every block starts on a cache line. Handles, pool entities and indices, trivially copyable
+    // components, the columns of columnar ones and the value indices of shared ones are stored
+    // exactly as they are in memory and padded to whole pages, so loading maps the file and adopts
+    // those blocks as pages in place instead of copying them.
+    class WorldSerializer
+    {
+    public:
+        static constexpr uint32_t MAGIC = 0x57455A48; // "HZEW"
+        static constexpr uint32_t VERSION = 2;
+
+        // The built-in Disabled tag is registered from the start
+        WorldSerializer();
+
+        // Trivially copyable components are written as they are and loaded zero-copy. The name
+        // identifies the type in files and must stay the same between builds. Tags only store
+        // their entities, components stored in columns are written column by column and shared
+        // ones as their value indices followed by the value table.
+        template <typename T>
+        void RegisterComponent(const std::string& name)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Components that are not trivially copyable need fix-up hooks.");
+
+            if constexpr (ComponentArray<T>::IS_TAG)
+            {
+                ComponentFormat format = MakeFormat<T>(name, 0, 1);
+                format.Write = [](const ComponentManager&, std::ostream&)
+                {
+                };
+                format.Read = [](ComponentManager& components, const PoolHeader&, EntitySet entities, char*, const Ref<MappedFile>&)
+                {
+                    components.GetComponentArray<T>()->Load({}, std::move(entities));
+                };
+                AddFormat(std::move(format));
+            }
+            else if constexpr (ComponentArray<T>::IS_COLUMNAR)
+            {
+                using Layout = typename ComponentTraits<T>::Columns;
+                ComponentFormat format = MakeFormat<T>(name, ColumnsSize(Layout()), ComponentArray<T>::PAGE_SIZE);
+                format.Write = [](const ComponentManager& components, std::ostream& out)
+                {
+                    WriteColumns(components.GetComponentArray<T>()->Components(), out, Layout());
+                };
+                format.Read = [](ComponentManager& components, const PoolHeader& pool, EntitySet entities,
+                                 char* data, const Ref<MappedFile>& file)
+                {
+                    components.GetComponentArray<T>()->Load(
+                        ReadColumns<T>(pool, data, file, Layout()), std::move(entities));
+                };
+                AddFormat(std::move(format));
+            }
+            else if constexpr (ComponentArray<T>::IS_SHARED)
+            {
+                const auto identity = [](const T& value) { return value; };
+                AddSharedFormat<T, T>(name, identity, identity);
+            }
+            else
+            {
+                ComponentFormat format = MakeFormat<T>(name, sizeof(T), ComponentArray<T>::PAGE_SIZE);
+                format.Write = [](const ComponentManager& components, std::ostream& out)
+                {
+                    WritePages(components.GetComponentArray<T>()->Components(), out);
+                };
+                format.Read = [](ComponentManager& components, const PoolHeader& pool, EntitySet entities,
+                                 char* data, const Ref<MappedFile>& file)
+                {
+                    components.GetComponentArray<T>()->Load(
+                        ReadPages<T, ComponentArray<T>::PAGE_SIZE>(pool, data, file), std::move(entities));
+                };
+                AddFormat(std::move(format));
+            }
+        }
+
+        // Other components are written as Record, which must be trivially copyable, and converted by
+        // fix-up hooks on either side, e.g. replacing a texture reference by an index into a table.
+        // The hooks of shared components only see the distinct values.
+        template <typename T, typename Record>
+        void RegisterComponent(const std::string& name, std::function<Record(const T&)> save, std::function<T(const Record&)> load)
+        {
+            static_assert(std::is_trivially_copyable_v<Record>, "Component records must be trivially copyable.");
+
+            if constexpr (ComponentArray<T>::IS_SHARED)
+            {
+                AddSharedFormat<T, Record>(name, std::move(save), std::move(load));
+            }
+            else
+            {
+                ComponentFormat format = MakeFormat<T>(name, sizeof(Record), 1);
+                format.Write = [save](const ComponentManager& components, std::ostream& out)
+                {
+                    const auto* componentArray = components.GetComponentArray<T>();
+                    for (unsigned i = 0; i < componentArray->Size(); ++i)
+                    {
+                        const Record record = save(componentArray->At(i));
+                        out.write(reinterpret_cast<const char*>(&record), sizeof(Record));
+                    }
+                };
+                format.Read = [load](ComponentManager& components, const PoolHeader& pool, EntitySet entities,
+                                     char* data, const Ref<MappedFile>&)
+                {
+                    const Record* records = reinterpret_cast<const Record*>(data);
+                    typename ComponentArray<T>::Storage loaded;
+                    loaded.Reserve(pool.Count);
+                    for (unsigned i = 0; i < pool.Count; ++i)
+                    {
+                        loaded.EmplaceBack(load(records[i]));
+                    }
+                    components.GetComponentArray<T>()->Load(std::move(loaded), std::move(entities));
+                };
+                AddFormat(std::move(format));
+            }
+        }
+
+        // Writes every entity and the components of the registered types that ecs has registered
+        bool Save(const ECS& ecs, const std::string& path) const;
+
+        // Replaces the entities and components of ecs with those in the file. Pools whose type is
+        // not registered with both the serializer and ecs are skipped. Systems are notified as the
+        // old entities leave and the loaded ones arrive, and get OnWorldReset() before updating.
+        bool Load(ECS& ecs, const std::string& path) const;
+
+    private:
+        struct FileHeader
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t EntityIndexBits;
+            uint32_t HandlePageSize;
+            uint32_t EntityPageSize;
+            uint32_t PoolCount;
+            uint32_t SlotCount;
+            uint32_t LivingEntityCount;
+            uint32_t FreeHead;
+            uint32_t FreeTail;
+            uint64_t HandlesOffset;
+            uint64_t SignaturesOffset;
+        };
+
+        struct PoolHeader
+        {
+            uint64_t NameHash;
+            uint32_t ElementSize;
+            uint32_t PageSize;
+            uint32_t Count;
+            uint32_t SparsePageCount;
+            uint64_t EntitiesOffset;
+            uint64_t SparsePageIndicesOffset;
+            uint64_t SparsePagesOffset;
+            uint64_t DataOffset;
+
+            // Table of distinct values of shared components, empty for the others
+            uint32_t ValueSize;
+            uint32_t ValueCount;
+            uint64_t ValuesOffset;
+        };
+
+        struct ComponentFormat
+        {
+            std::string Name;
+            uint64_t NameHash;
+            ComponentType Type;
+
+            // Size of a stored element and elements per padded page, 1 for unpadded record blocks
+            uint32_t ElementSize;
+            uint32_t PageSize;
+
+            // Size of a stored value table entry, 0 for pools without a value table
+            uint32_t ValueSize = 0;
+
+            std::function<const EntitySet&(const ComponentManager&)> Entities;
+            std::function<void(const ComponentManager&, std::ostream&)> Write;
+            std::function<void(ComponentManager&, const PoolHeader&, EntitySet, char*, const Ref<MappedFile>&)> Read;
+
+            // Set for pools with a value table
+            std::function<uint32_t(const ComponentManager&)> ValueCount;
+            std::function<void(const ComponentManager&, std::ostream&)> WriteValues;
+
+            // Checks what the bounds do not cover before the world is replaced, may be empty
+            std::function<bool(const PoolHeader&, const char*)> Validate;
+        };
+
+        template <typename T>
+        static ComponentFormat MakeFormat(const std::string& name, uint32_t elementSize, uint32_t pageSize)
+        {
+            ComponentFormat format;
+            format.Name = name;
+            format.NameHash = HashName(name);
+            format.Type = ComponentTypeOf<T>();
+            format.ElementSize = elementSize;
+            format.PageSize = pageSize;
+            format.Entities = [](const ComponentManager& components) -> const EntitySet&
+            {
+                return components.GetComponentArray<T>()->Entities();
+            };
+            return format;
+        }
+
+        // Shared components: the value index of every component, then the table of values as records
+        template <typename T, typename Record, typename Save, typename Load>
+        void AddSharedFormat(const std::string& name, Save save, Load load)
+        {
+            using Storage = typename ComponentArray<T>::Storage;
+
+            ComponentFormat format = MakeFormat<T>(name, sizeof(SharedIndex), Storage::PAGE_SIZE);
+            format.ValueSize = sizeof(Record);
+            format.ValueCount = [](const ComponentManager& components)
+            {
+                return components.GetComponentArray<T>()->Components().Values().Capacity();
+            };
+            format.Write = [](const ComponentManager& components, std::ostream& out)
+            {
+                WritePages(components.GetComponentArray<T>()->Components().Indices(), out);
+            };
+            format.WriteValues = [save](const ComponentManager& components, std::ostream& out)
+            {
+                // Free slots are written as zeros, the hooks never see them
+                const SharedValueTable<T>& values = components.GetComponentArray<T>()->Components().Values();
+                for (SharedIndex index = 0; index < values.Capacity(); ++index)
+                {
+                    if (values.References(index) > 0)
+                    {
+                        const Record record = save(values[index]);
+                        out.write(reinterpret_cast<const char*>(&record), sizeof(Record));
+                    }
+                    else
+                    {
+                        WritePadding(out, sizeof(Record));
+                    }
+                }
+            };
+            format.Validate = [](const PoolHeader& pool, const char* data)
+            {
+                const SharedIndex* indices = reinterpret_cast<const SharedIndex*>(data);
+                return std::all_of(indices, indices + pool.Count, [&pool](SharedIndex index) { return index < pool.ValueCount; });
+            };
+            format.Read = [load](ComponentManager& components, const PoolHeader& pool, EntitySet entities,
+                                 char* data, const Ref<MappedFile>& file)
+            {
+                PagedVector<SharedIndex, Storage::PAGE_SIZE> indices = ReadPages<SharedIndex, Storage::PAGE_SIZE>(pool, data, file);
+                std::vector<unsigned> references(pool.ValueCount, 0);
+                for (unsigned i = 0; i < indices.Size(); ++i)
+                {
+                    ++references[indices[i]];
+                }
+
+                const Record* records = reinterpret_cast<const Record*>(file->GetData() + pool.ValuesOffset);
+                std::vector<T> values(pool.ValueCount);
+                for (uint32_t index = 0; index < pool.ValueCount; ++index)
+                {
+                    if (references[index] > 0)
+                    {
+                        values[index] = load(records[index]);
+                    }
+                }
+                components.GetComponentArray<T>()->Load(
+                    Storage::Load(std::move(indices), std::move(values), std::move(references)), std::move(entities));
+            };
+            AddFormat(std::move(format));
+        }
+
+        // Writes the pages of values and pads them to a whole number of pages
+        template <typename Vector>
+        static void WritePages(const Vector& values, std::ostream& out)
+        {
+            for (unsigned page = 0; page < values.PageCount(); ++page)
+            {
+                out.write(reinterpret_cast<const char*>(values.PageAt(page)->Data()), values.PageAt(page)->Count() * sizeof(values[0]));
+            }
+            WritePadding(out, (PaddedCount(values.Size(), Vector::PAGE_SIZE) - values.Size()) * sizeof(values[0]));
+        }
+
+        // Adopts a block written by WritePages, or copies it if it was written with another page size
+        template <typename T, unsigned PageSize>
+        static PagedVector<T, PageSize> ReadPages(const PoolHeader& pool, char* data, const Ref<MappedFile>& file)
+        {
+            T* values = reinterpret_cast<T*>(data);
+            if (pool.PageSize == PageSize)
+            {
+                return PagedVector<T, PageSize>::Adopt(values, pool.Count, file);
+            }
+
+            PagedVector<T, PageSize> loaded;
+            loaded.Reserve(pool.Count);
+            for (unsigned i = 0; i < pool.Count; ++i)
+            {
+                loaded.EmplaceBack(values[i]);
+            }
+            return loaded;
+        }
+
+        template <auto... Members>
+        static constexpr uint32_t ColumnsSize(ColumnLayout<Members...>)
+        {
+            return (sizeof(MemberType<Members>) + ...);
+        }
+
+        // Every column as one padded block, in the order of the layout
+        template <typename Storage, auto... Members>
+        static void WriteColumns(const Storage& storage, std::ostream& out, ColumnLayout<Members...>)
+        {
+            (WritePages(storage.template Column<Members>(), out), ...);
+        }
+
+        // Adopts the columns written by WriteColumns, or gathers the components if they were written
+        // with another page size
+        template <typename T, auto... Members>
+        static typename ComponentArray<T>::Storage ReadColumns(const PoolHeader& pool, char* data, const Ref<MappedFile>& file,
+                                                               ColumnLayout<Members...>)
+        {
+            using Storage = typename ComponentArray<T>::Storage;
+
+            // Braced lists are evaluated in order, so the columns are found front to back
+            size_t offset = 0;
+            const auto next = [&offset, &pool, data](size_t memberSize)
+            {
+                char* column = data + offset;
+                offset += PaddedCount(pool.Count, pool.PageSize) * memberSize;
+                return column;
+            };
+            char* const columns[] = {next(sizeof(MemberType<Members>))...};
+
+            if (pool.PageSize == Storage::PAGE_SIZE)
+            {
+                return Storage::Adopt(pool.Count, file, reinterpret_cast<MemberType<Members>*>(columns[ColumnIndex<Members, Members...>()])...);
+            }
+
+            Storage loaded;
+            loaded.Reserve(pool.Count);
+            for (unsigned i = 0; i < pool.Count; ++i)
+            {
+                T value{};
+                ((value.*Members = reinterpret_cast<MemberType<Members>*>(columns[ColumnIndex<Members, Members...>()])[i]), ...);
+                loaded.EmplaceBack(value);
+            }
+            return loaded;
+        }
+
+        void AddFormat(ComponentFormat format);
+
+        static uint64_t HashName(const std::string& name);
+
+        static size_t PaddedCount(size_t count, size_t pageSize)
+        {
+            return (count + pageSize - 1) / pageSize * pageSize;
+        }
+
+        static void WritePadding(std::ostream& out, size_t bytes);
+
+        std::vector<ComponentFormat> m_Formats;
+    };
+}
@@ -1,6 +1,8 @@
 ﻿#include "hzpch.h"
 #include "OrthographicCamera.h"
 
+#include <limits>
+
 #include "glm/gtc/matrix_transform.hpp"
 #include "Hazel/Debug/Instrumentor.h"
 
@@ -22,6 +24,20 @@ namespace Hazel
         m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
     }
 
+    AABB OrthographicCamera::GetWorldBounds() const
+    {
+        // Corners of clip space back in the world, a rotated camera sees a rotated rectangle
+        const glm::mat4 inverse = glm::inverse(m_ViewProjectionMatrix);
+        AABB bounds = {glm::vec2(std::numeric_limits<float>::max()), glm::vec2(std::numeric_limits<float>::lowest())};
+        for (const glm::vec2 corner : {glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(-1.0f, 1.0f), glm::vec2(1.0f, 1.0f)})
+        {
+            const glm::vec2 world = glm::vec2(inverse * glm::vec4(corner, 0.0f, 1.0f));
+            bounds.Min = glm::min(bounds.Min, world);
+            bounds.Max = glm::max(bounds.Max, world);
+        }
+        return bounds;
+    }
+
     void OrthographicCamera::RecalculateViewMatrix()
     {
         HZ_PROFILE_FUNCTION();
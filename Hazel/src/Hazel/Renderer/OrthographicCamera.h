@@ -1,6 +1,8 @@
 ﻿#pragma once
 #include "glm/mat4x4.hpp"
 
+#include "Hazel/Core/AABB.h"
+
 namespace Hazel
 {
     class OrthographicCamera
@@ -47,6 +49,9 @@ namespace Hazel
             return m_ViewProjectionMatrix;
         }
 
+        // World space bounds of what the camera sees, for culling
+        AABB GetWorldBounds() const;
+
     private:
 
         void RecalculateViewMatrix();
@@ -174,6 +174,34 @@ namespace Hazel
     {
         HZ_PROFILE_FUNCTION();
 
+        glm::mat4 transform = translate(glm::mat4(1.0f), position)
+            * scale(glm::mat4(1.0f), {size.x, size.y, 1.0f});
+
+        DrawQuad(transform, color);
+    }
+
+
+    void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& texture,
+                              float tilingFactor, const glm::vec4& tintColor)
+    {
+        DrawQuad({position.x, position.y, 0.0f}, size, texture, tilingFactor);
+    }
+
+    void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture,
+                              float tilingFactor, const glm::vec4& tintColor)
+    {
+        HZ_PROFILE_FUNCTION();
+
+        glm::mat4 transform = translate(glm::mat4(1.0f), position)
+            * scale(glm::mat4(1.0f), {size.x, size.y, 1.0f});
+
+        DrawQuad(transform, texture, tilingFactor, tintColor);
+    }
+
+    void Renderer2D::DrawQuad(const glm::mat4& transform, const glm::vec4& color)
+    {
+        HZ_PROFILE_FUNCTION();
+
         if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
         {
             FlushAndReset();
@@ -181,9 +209,6 @@ namespace Hazel
 
         constexpr float texIndex = 0.0f;
 
-        glm::mat4 transform = translate(glm::mat4(1.0f), position)
-            * scale(glm::mat4(1.0f), {size.x, size.y, 1.0f});
-
         s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[0];
         s_Data.QuadVertexBufferPtr->Color = color;
         s_Data.QuadVertexBufferPtr->TexCoord = {0.0f, 0.0f};
@@ -217,21 +242,13 @@ namespace Hazel
         s_Data.Stats.QuadCount++;
     }
 
-
-    void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& texture,
-                              float tilingFactor, const glm::vec4& tintColor)
-    {
-        DrawQuad({position.x, position.y, 0.0f}, size, texture, tilingFactor);
-    }
-
-    void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture,
-                              float tilingFactor, const glm::vec4& tintColor)
+    void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor,
+                              const glm::vec4& tintColor)
     {
         HZ_PROFILE_FUNCTION();
         if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices) {
             FlushAndReset();
         }
-        constexpr glm::vec4 color(1.0f);
 
         float texIndex = 0;
 
@@ -251,9 +268,6 @@ namespace Hazel
             s_Data.TextureSlotIndex++;
         }
 
-        glm::mat4 transform = translate(glm::mat4(1.0f), position)
-            * scale(glm::mat4(1.0f), {size.x, size.y, 1.0f});
-
         s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[0];
         s_Data.QuadVertexBufferPtr->Color = tintColor;
         s_Data.QuadVertexBufferPtr->TexCoord = {0.0f, 0.0f};
@@ -297,46 +311,12 @@ namespace Hazel
                                      const glm::vec4& color)
     {
         HZ_PROFILE_FUNCTION();
-        if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices) {
-            FlushAndReset();
-        }
-        constexpr float texIndex = 0.0f;
 
         glm::mat4 transform = translate(glm::mat4(1.0f), position)
             * rotate(glm::mat4(1.0f), glm::radians(rotation), {0.0f, 0.0f, 1.0f})
             * scale(glm::mat4(1.0f), {size.x, size.y, 1.0f});
 
-        s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[0];
-        s_Data.QuadVertexBufferPtr->Color = color;
-        s_Data.QuadVertexBufferPtr->TexCoord = {0.0f, 0.0f};
-        s_Data.QuadVertexBufferPtr->TexIndex = texIndex;
-        s_Data.QuadVertexBufferPtr->TilingFactor = 1.0f;
-        s_Data.QuadVertexBufferPtr++;
-
-        s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[1];
-        s_Data.QuadVertexBufferPtr->Color = color;
-        s_Data.QuadVertexBufferPtr->TexCoord = {1.0f, 0.0f};
-        s_Data.QuadVertexBufferPtr->TexIndex = texIndex;
-        s_Data.QuadVertexBufferPtr->TilingFactor = 1.0f;
-        s_Data.QuadVertexBufferPtr++;
-
-        s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[2];
-        s_Data.QuadVertexBufferPtr->Color = color;
-        s_Data.QuadVertexBufferPtr->TexCoord = {1.0f, 1.0f};
-        s_Data.QuadVertexBufferPtr->TexIndex = texIndex;
-        s_Data.QuadVertexBufferPtr->TilingFactor = 1.0f;
-        s_Data.QuadVertexBufferPtr++;
-
-        s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[3];
-        s_Data.QuadVertexBufferPtr->Color = color;
-        s_Data.QuadVertexBufferPtr->TexCoord = {0.0f, 1.0f};
-        s_Data.QuadVertexBufferPtr->TexIndex = texIndex;
-        s_Data.QuadVertexBufferPtr->TilingFactor = 1.0f;
-        s_Data.QuadVertexBufferPtr++;
-
-        s_Data.QuadIndexCount += 6;
-
-        s_Data.Stats.QuadCount++;
+        DrawQuad(transform, color);
     }
 
     void Renderer2D::DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation,
@@ -349,62 +329,12 @@ namespace Hazel
                                      const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor)
     {
         HZ_PROFILE_FUNCTION();
-        if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices) {
-            FlushAndReset();
-        }
-        float texIndex = 0;
-
-        for (unsigned i = 1; i < s_Data.TextureSlotIndex; i++)
-        {
-            if (*s_Data.TextureSlots[i] == *texture)
-            {
-                texIndex = (float)i;
-                break;
-            }
-        }
-
-        if (texIndex == 0.0f)
-        {
-            texIndex = (float)s_Data.TextureSlotIndex;
-            s_Data.TextureSlots[s_Data.TextureSlotIndex] = texture;
-            s_Data.TextureSlotIndex++;
-        }
 
         glm::mat4 transform = translate(glm::mat4(1.0f), position)
             * rotate(glm::mat4(1.0f), glm::radians(rotation), {0.0f, 0.0f, 1.0f})
             * scale(glm::mat4(1.0f), {size.x, size.y, 1.0f});
 
-        s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[0];
-        s_Data.QuadVertexBufferPtr->Color = tintColor;
-        s_Data.QuadVertexBufferPtr->TexCoord = {0.0f, 0.0f};
-        s_Data.QuadVertexBufferPtr->TexIndex = texIndex;
-        s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-        s_Data.QuadVertexBufferPtr++;
-
-        s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[1];
-        s_Data.QuadVertexBufferPtr->Color = tintColor;
-        s_Data.QuadVertexBufferPtr->TexCoord = {1.0f, 0.0f};
-        s_Data.QuadVertexBufferPtr->TexIndex = texIndex;
-        s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-        s_Data.QuadVertexBufferPtr++;
-
-        s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[2];
-        s_Data.QuadVertexBufferPtr->Color = tintColor;
-        s_Data.QuadVertexBufferPtr->TexCoord = {1.0f, 1.0f};
-        s_Data.QuadVertexBufferPtr->TexIndex = texIndex;
-        s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-        s_Data.QuadVertexBufferPtr++;
-
-        s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[3];
-        s_Data.QuadVertexBufferPtr->Color = tintColor;
-        s_Data.QuadVertexBufferPtr->TexCoord = {0.0f, 1.0f};
-        s_Data.QuadVertexBufferPtr->TexIndex = texIndex;
-        s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-        s_Data.QuadVertexBufferPtr++;
-
-        s_Data.QuadIndexCount += 6;
-
-        s_Data.Stats.QuadCount++;
+        DrawQuad(transform, texture, tilingFactor, tintColor);
     }
 
     Renderer2D::Statistics Renderer2D::GetStats()
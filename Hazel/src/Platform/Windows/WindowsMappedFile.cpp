@@ -0,0 +1,56 @@
+#include "hzpch.h"
+#include "WindowsMappedFile.h"
+
+namespace Hazel
+{
+    Ref<MappedFile> MappedFile::Open(const std::string& path)
+    {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            HZ_CORE_ERROR("Could not open file '{0}'", path);
+            return nullptr;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            HZ_CORE_ERROR("Could not map empty file '{0}'", path);
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            HZ_CORE_ERROR("Could not map file '{0}'", path);
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        // Copy-on-write view, so that loaded components can be modified in place
+        void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+        if (!data)
+        {
+            HZ_CORE_ERROR("Could not map a view of file '{0}'", path);
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        return CreateRef<WindowsMappedFile>(file, mapping, static_cast<char*>(data), static_cast<size_t>(size.QuadPart));
+    }
+
+    WindowsMappedFile::WindowsMappedFile(HANDLE file, HANDLE mapping, char* data, size_t size)
+        : m_File(file), m_Mapping(mapping), m_Data(data), m_Size(size)
+    {
+    }
+
+    WindowsMappedFile::~WindowsMappedFile()
+    {
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+        CloseHandle(m_File);
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Hazel/Core/MappedFile.h"
+
+namespace Hazel
+{
+    class WindowsMappedFile : public MappedFile
+    {
+    public:
+        WindowsMappedFile(HANDLE file, HANDLE mapping, char* data, size_t size);
+        ~WindowsMappedFile() override;
+
+        WindowsMappedFile(const WindowsMappedFile&) = delete;
+        WindowsMappedFile& operator=(const WindowsMappedFile&) = delete;
+
+        char* GetData() override
+        {
+            return m_Data;
+        }
+
+        size_t GetSize() const override
+        {
+            return m_Size;
+        }
+
+    private:
+        HANDLE m_File;
+        HANDLE m_Mapping;
+        char* m_Data;
+        size_t m_Size;
+    };
+}
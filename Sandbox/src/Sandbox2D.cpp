@@ -1,15 +1,83 @@
 ﻿#include "Sandbox2D.h"
 
+#include <algorithm>
+
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <imgui/imgui.h>
 
 
 #include "Hazel/ECS/Components.h"
+#include "Hazel/ECS/RewindBuffer.h"
+#include "Hazel/ECS/Systems.h"
 #include "Hazel/Renderer/ParticleSystem.h"
 
 Sandbox2D::Sandbox2D() : Layer("Sandbox2D"), m_CameraController(1280.0f / 720.0f, true)
 {
+    // The demo world's components and systems, other layers keep an empty world
+    m_ECS.RegisterComponent<Hazel::Gravity>();
+    m_ECS.RegisterComponent<Hazel::Transform>();
+    m_ECS.RegisterComponent<Hazel::RigidBody>();
+    m_ECS.RegisterComponent<Hazel::Colored>();
+    m_ECS.RegisterComponent<Hazel::Textured>();
+    m_ECS.RegisterComponent<Hazel::Drawable>();
+    m_ECS.RegisterComponent<Hazel::Health>();
+    m_ECS.RegisterComponent<Hazel::Parent>();
+    m_ECS.RegisterComponent<Hazel::Children>();
+    m_ECS.RegisterComponent<Hazel::WorldTransform>();
+
+    // The renderer's quads, drawn without looking up their components one by one
+    m_ECS.RegisterGroup<Hazel::Transform, Hazel::Colored, Hazel::Drawable>();
+
+    // Registered first, so that the systems reading transforms after it see this frame's positions
+    m_ECS.RegisterSystem<Hazel::PhysicsSystem>();
+    {
+        m_ECS.SetSystemSignature<Hazel::PhysicsSystem>(m_ECS.MakeSignature<Hazel::Transform, Hazel::RigidBody>());
+        m_ECS.SetSystemAccess<Hazel::PhysicsSystem>(
+            m_ECS.MakeSignature<Hazel::Transform, Hazel::RigidBody, Hazel::Gravity>(),
+            m_ECS.MakeSignature<Hazel::Transform, Hazel::RigidBody>());
+    }
+
+    // After the physics moved the transforms, before the renderer draws the world matrices
+    m_ECS.EnableChangeTracking<Hazel::Transform>();
+    m_ECS.EnableChangeTracking<Hazel::Parent>();
+    m_ECS.RegisterSystem<Hazel::TransformPropagationSystem>();
+    {
+        m_ECS.SetSystemSignature<Hazel::TransformPropagationSystem>(
+            m_ECS.MakeSignature<Hazel::Transform, Hazel::WorldTransform>());
+        m_ECS.SetSystemAccess<Hazel::TransformPropagationSystem>(
+            m_ECS.MakeSignature<Hazel::Transform, Hazel::Parent, Hazel::WorldTransform>(),
+            m_ECS.MakeSignature<Hazel::WorldTransform>());
+    }
+
+    m_ECS.RegisterSystem<Hazel::RendererSystem>();
+    {
+        Hazel::Signature signature;
+        signature.set(m_ECS.GetComponentType<Hazel::Transform>());
+        signature.set(m_ECS.GetComponentType<Hazel::Drawable>());
+        signature.set(m_ECS.GetComponentType<Hazel::Colored>());
+        m_ECS.SetSystemSignature<Hazel::RendererSystem>(signature);
+        // Renderer2D is bound to the main thread's GL context. Sorting the quads moves the
+        // components of the group.
+        m_ECS.SetSystemAccess<Hazel::RendererSystem>(
+            m_ECS.MakeSignature<Hazel::Transform, Hazel::WorldTransform, Hazel::Drawable, Hazel::Colored, Hazel::Textured>(),
+            m_ECS.MakeSignature<Hazel::Transform, Hazel::Drawable, Hazel::Colored>(), true);
+    }
+
+    // Keeps the spatial index in sync with the transforms that changed since its last update
+    m_ECS.RegisterSystem<Hazel::SpatialIndexSystem>();
+    {
+        m_ECS.SetSystemSignature<Hazel::SpatialIndexSystem>(m_ECS.MakeSignature<Hazel::Transform>());
+        m_ECS.SetSystemAccess<Hazel::SpatialIndexSystem>(m_ECS.MakeSignature<Hazel::Transform>(), Hazel::Signature());
+    }
+
+    // Reports the bodies overlapping after this frame's integration
+    m_ECS.RegisterSystem<Hazel::BroadphaseSystem>();
+    {
+        m_ECS.SetSystemSignature<Hazel::BroadphaseSystem>(
+            m_ECS.MakeSignature<Hazel::Transform, Hazel::RigidBody>());
+        m_ECS.SetSystemAccess<Hazel::BroadphaseSystem>(m_ECS.MakeSignature<Hazel::Transform>(), Hazel::Signature());
+    }
 }
 
 static Hazel::Entity s_Ent;
@@ -25,6 +93,38 @@ void Sandbox2D::OnAttach()
     Hazel::Entity e1 = m_ECS.CreateQuad({0.0f, 0.0f, 0.9f}, {3.0f, 2.0f}, m_CheckerboardTexture, 0.5f,
                                         {0.2f, 0.8f, 0.3f, 1.0f});
     s_Ent = e1;
+
+    m_Textures.push_back(m_CheckerboardTexture);
+
+    // Textures are saved as an index into m_Textures, a texture met while saving is appended to it
+    struct TexturedRecord
+    {
+        uint32_t TextureIndex;
+        float TilingFactor;
+    };
+    m_WorldSerializer.RegisterComponent<Hazel::Transform>("Transform");
+    m_WorldSerializer.RegisterComponent<Hazel::Colored>("Colored");
+    m_WorldSerializer.RegisterComponent<Hazel::Drawable>("Drawable");
+    m_WorldSerializer.RegisterComponent<Hazel::Textured, TexturedRecord>(
+        "Textured",
+        [this](const Hazel::Textured& textured)
+        {
+            auto it = std::find(m_Textures.begin(), m_Textures.end(), textured.Texture);
+            if (it == m_Textures.end())
+            {
+                it = m_Textures.insert(it, textured.Texture);
+            }
+            return TexturedRecord{static_cast<uint32_t>(it - m_Textures.begin()), textured.TilingFactor};
+        },
+        [this](const TexturedRecord& record)
+        {
+            if (record.TextureIndex >= m_Textures.size())
+            {
+                HZ_WARN("Texture {0} of the loaded world is unknown, using the checkerboard", record.TextureIndex);
+                return Hazel::Textured{m_CheckerboardTexture, record.TilingFactor};
+            }
+            return Hazel::Textured{m_Textures[record.TextureIndex], record.TilingFactor};
+        });
 }
 
 void Sandbox2D::OnDetach()
@@ -37,8 +137,8 @@ void Sandbox2D::OnUpdate(Hazel::Timestep ts)
     HZ_PROFILE_FUNCTION();
 
     {
-        auto& transform = m_ECS.GetComponent<Hazel::Transform>(s_Ent);
-        transform.Rotation -= 180.0f * ts;
+        auto transform = m_ECS.GetComponent<Hazel::Transform>(s_Ent);
+        transform.Get<&Hazel::Transform::Rotation>() -= 180.0f * ts;
     }
 
     {
@@ -59,16 +159,14 @@ void Sandbox2D::OnUpdate(Hazel::Timestep ts)
 
         Layer::OnUpdate(ts);
 
-        static Hazel::ECS ecs;
+        // Record every frame and jump back 45 frames every 180 frames
+        static Hazel::RewindBuffer rewind(64);
         static int i = 0;
         i++;
-        if (i % 180 == 45)
-        {
-            ecs = m_ECS;
-        }
-        else if (i % 180 == 90)
+        rewind.Record(m_ECS);
+        if (i % 180 == 90)
         {
-            m_ECS = ecs;
+            rewind.Restore(m_ECS, 45);
         }
 
         // particle effect
@@ -136,4 +234,20 @@ void Sandbox2D::OnImGuiRender()
 void Sandbox2D::OnEvent(Hazel::Event& event)
 {
     m_CameraController.OnEvent(event);
+
+    Hazel::EventDispatcher dispatcher(event);
+    dispatcher.Dispatch<Hazel::KeyPressedEvent>(HZ_BIND_EVENT_FN(Sandbox2D::OnKeyPressed));
+}
+
+bool Sandbox2D::OnKeyPressed(Hazel::KeyPressedEvent& event)
+{
+    if (event.GetKeyCode() == HZ_KEY_F5)
+    {
+        m_WorldSerializer.Save(m_ECS, "assets/Sandbox.hzworld");
+    }
+    else if (event.GetKeyCode() == HZ_KEY_F9)
+    {
+        m_WorldSerializer.Load(m_ECS, "assets/Sandbox.hzworld");
+    }
+    return false;
 }
@@ -1,5 +1,7 @@
 ﻿#pragma once
 #include "Hazel.h"
+#include "Hazel/ECS/WorldSerializer.h"
+#include "Hazel/Events/KeyEvent.h"
 
 
 class Sandbox2D : public Hazel::Layer
@@ -14,8 +16,16 @@ public:
     void OnEvent(Hazel::Event& event) override;
 
 private:
+    bool OnKeyPressed(Hazel::KeyPressedEvent& event);
+
     Hazel::OrthographicCameraController m_CameraController;
 
+    // F5 saves the world, F9 loads it back
+    Hazel::WorldSerializer m_WorldSerializer;
+
+    // Textures referenced by saved worlds, by index
+    std::vector<Hazel::Ref<Hazel::Texture2D>> m_Textures;
+
     // temp
     Hazel::Ref<Hazel::Shader> m_Shader;
     Hazel::Ref<Hazel::VertexArray> m_SquareVA;
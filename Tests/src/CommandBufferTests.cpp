@@ -0,0 +1,110 @@
+#include "Test.h"
+
+#include "Hazel/Core/ThreadPool.h"
+#include "Hazel/ECS/ECSCore.h"
+
+using namespace Hazel;
+
+namespace
+{
+    struct Value
+    {
+        int X;
+    };
+
+    struct Tag
+    {
+    };
+}
+
+TEST_CASE(CommandsPlayBackBySortKeyThenRecordingOrder)
+{
+    ECS ecs;
+    ecs.RegisterComponent<Value>();
+    const Entity entity = ecs.CreateEntity();
+
+    // The component ends up with the value of the last command to run
+    EntityCommandBuffer& commands = ecs.GetCommandBuffer();
+    commands.AddComponent(2, entity, Value{3});
+    commands.AddComponent(1, entity, Value{1});
+    commands.AddComponent(2, entity, Value{4});
+    commands.AddComponent(1, entity, Value{2});
+    commands.Playback(ecs);
+    CHECK(commands.Empty());
+    CHECK(ecs.GetComponent<Value>(entity).X == 4);
+
+    commands.AddComponent(0, entity, Value{5});
+    commands.RemoveComponent<Value>(0, entity);
+    commands.Playback(ecs);
+    CHECK(!ecs.HasComponent<Value>(entity));
+}
+
+TEST_CASE(ProvisionalHandlesResolveAtPlayback)
+{
+    ECS ecs;
+    ecs.RegisterComponent<Value>();
+    ecs.RegisterComponent<Tag>();
+
+    EntityCommandBuffer& commands = ecs.GetCommandBuffer();
+    const Entity first = commands.CreateEntity(1, Value{1});
+    const Entity second = commands.CreateEntity(1, Value{2});
+    CHECK(IsProvisional(first) && IsProvisional(second) && first != second);
+    CHECK(!ecs.IsAlive(first));
+
+    commands.AddComponent(1, first, Tag{});
+    commands.DestroyEntity(1, second);
+
+    // Runs before the entity exists, so it is skipped
+    commands.AddComponent(0, first, Value{0});
+    commands.Playback(ecs);
+
+    unsigned count = 0;
+    ecs.View<const Value, const Tag>().Each([&count](Entity entity, const Value& value, const Tag&)
+    {
+        CHECK(!IsProvisional(entity));
+        CHECK(value.X == 1);
+        ++count;
+    });
+    CHECK(count == 1);
+    CHECK(ecs.View<const Value>().SizeHint() == 1);
+
+    // Numbering restarts after a playback
+    CHECK(commands.CreateEntity(0, Value{3}) == first);
+    commands.Playback(ecs);
+    CHECK(ecs.View<const Value>().SizeHint() == 2);
+}
+
+TEST_CASE(ParallelRecordingPlaysBackDeterministically)
+{
+    ThreadPool pool(3);
+    constexpr unsigned ITEM_COUNT = 2000;
+
+    // Every item records under its own key, each thread's commands keep their order within it
+    auto run = [&pool]
+    {
+        ECS ecs;
+        ecs.RegisterComponent<Value>();
+        EntityCommandBuffer& commands = ecs.GetCommandBuffer();
+        pool.ParallelFor(ITEM_COUNT, [&commands](unsigned item)
+        {
+            const Entity entity = commands.CreateEntity(item, Value{-1});
+            commands.AddComponent(item, entity, Value{static_cast<int>(item)});
+        });
+        commands.Playback(ecs);
+
+        std::vector<int> values;
+        ecs.View<const Value>().Each([&values](Entity entity, const Value& value)
+        {
+            CHECK(static_cast<int>(EntityIndex(entity)) == value.X);
+            values.push_back(value.X);
+        });
+        return values;
+    };
+
+    const std::vector<int> values = run();
+    CHECK(values.size() == ITEM_COUNT);
+    for (unsigned attempt = 0; attempt < 4; ++attempt)
+    {
+        CHECK(run() == values);
+    }
+}
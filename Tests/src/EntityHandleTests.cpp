@@ -0,0 +1,105 @@
+#include "Test.h"
+
+#include "Hazel/ECS/ECSCore.h"
+
+using namespace Hazel;
+
+namespace
+{
+    struct Value
+    {
+        int X;
+    };
+}
+
+TEST_CASE(EntityHandlesPackIndexAndGeneration)
+{
+    const Entity entity = MakeEntity(1234, 56);
+    CHECK(EntityIndex(entity) == 1234);
+    CHECK(EntityGeneration(entity) == 56);
+
+    // The generation wraps instead of spilling into the index
+    const Entity wrapped = MakeEntity(7, ENTITY_GENERATION_MASK + 1);
+    CHECK(EntityIndex(wrapped) == 7);
+    CHECK(EntityGeneration(wrapped) == 0);
+}
+
+TEST_CASE(DestroyedHandlesGoStale)
+{
+    EntityManager manager;
+    const Entity a = manager.CreateEntity();
+    const Entity b = manager.CreateEntity();
+    CHECK(EntityIndex(a) == 0 && EntityGeneration(a) == 0);
+    CHECK(EntityIndex(b) == 1 && EntityGeneration(b) == 0);
+    CHECK(manager.IsAlive(a) && manager.IsAlive(b));
+    CHECK(!manager.IsAlive(NULL_ENTITY));
+
+    manager.DestroyEntity(a);
+    CHECK(!manager.IsAlive(a));
+    CHECK(manager.IsAlive(b));
+    CHECK(manager.GetLivingEntityCount() == 1);
+
+    // The slot comes back with the next generation, the old handle stays stale
+    const Entity c = manager.CreateEntity();
+    CHECK(EntityIndex(c) == EntityIndex(a));
+    CHECK(EntityGeneration(c) == 1);
+    CHECK(manager.IsAlive(c));
+    CHECK(!manager.IsAlive(a));
+    CHECK(manager.GetSlotCount() == 2);
+}
+
+TEST_CASE(FreeSlotsAreRecycledOldestFirst)
+{
+    EntityManager manager;
+    std::vector<Entity> entities;
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        entities.push_back(manager.CreateEntity());
+    }
+
+    for (const unsigned index : {5u, 2u, 7u})
+    {
+        manager.DestroyEntity(entities[index]);
+    }
+    CHECK(EntityIndex(manager.CreateEntity()) == 5);
+    CHECK(EntityIndex(manager.CreateEntity()) == 2);
+    CHECK(EntityIndex(manager.CreateEntity()) == 7);
+
+    // Free list exhausted, a new slot is appended
+    CHECK(EntityIndex(manager.CreateEntity()) == 8);
+    CHECK(manager.GetLivingEntityCount() == 9);
+}
+
+TEST_CASE(RecycledSlotsDoNotInheritComponents)
+{
+    ECS ecs;
+    ecs.RegisterComponent<Value>();
+
+    const Entity old = ecs.CreateEntityWith(Value{1});
+    ecs.DestroyEntity(old);
+    const Entity recycled = ecs.CreateEntity();
+    CHECK(EntityIndex(recycled) == EntityIndex(old));
+    CHECK(!ecs.IsAlive(old));
+    CHECK(!ecs.HasComponent<Value>(recycled));
+
+    ecs.AddComponent(recycled, Value{2});
+    CHECK(ecs.HasComponent<Value>(recycled));
+    CHECK(ecs.GetComponent<Value>(recycled).X == 2);
+}
+
+TEST_CASE(GenerationsSkipTheProvisionalOne)
+{
+    EntityManager manager;
+    Entity entity = manager.CreateEntity();
+    for (unsigned generation = 0; generation < PROVISIONAL_GENERATION; ++generation)
+    {
+        CHECK(!IsProvisional(entity));
+        manager.DestroyEntity(entity);
+        entity = manager.CreateEntity();
+    }
+
+    // Wrapped around without ever handing out a provisional handle
+    CHECK(EntityIndex(entity) == 0 && EntityGeneration(entity) == 0);
+    CHECK(!manager.IsAlive(MakeEntity(0, PROVISIONAL_GENERATION)));
+    CHECK(!IsProvisional(NULL_ENTITY));
+}
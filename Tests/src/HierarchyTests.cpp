@@ -0,0 +1,79 @@
+#include "Test.h"
+
+#include "Hazel/ECS/ECSCore.h"
+
+using namespace Hazel;
+
+namespace
+{
+    void RegisterHierarchy(ECS& ecs)
+    {
+        ecs.RegisterComponent<Parent>();
+        ecs.RegisterComponent<Children>();
+        ecs.RegisterComponent<WorldTransform>();
+    }
+
+    const std::vector<Entity>& ChildrenOf(ECS& ecs, Entity entity)
+    {
+        return ecs.GetComponent<const Children>(entity).Handles;
+    }
+}
+
+TEST_CASE(DestroyedChildrenLeaveTheirParent)
+{
+    ECS ecs;
+    RegisterHierarchy(ecs);
+    const Entity parent = ecs.CreateEntity();
+    const Entity first = ecs.CreateEntity();
+    const Entity second = ecs.CreateEntity();
+    CHECK(ecs.SetParent(first, parent));
+    CHECK(ecs.SetParent(second, parent));
+
+    ecs.DestroyEntity(first);
+    CHECK((ChildrenOf(ecs, parent) == std::vector<Entity>{second}));
+}
+
+TEST_CASE(DestroyedParentsOrphanTheirChildren)
+{
+    ECS ecs;
+    RegisterHierarchy(ecs);
+    const Entity root = ecs.CreateEntity();
+    const Entity parent = ecs.CreateEntity();
+    const Entity child = ecs.CreateEntity();
+    CHECK(ecs.SetParent(parent, root));
+    CHECK(ecs.SetParent(child, parent));
+
+    ecs.DestroyEntity(parent);
+    CHECK(ChildrenOf(ecs, root).empty());
+    CHECK(ecs.GetComponent<const Parent>(child).Handle == NULL_ENTITY);
+
+    // The orphan can be parented again, and the recycled slot does not adopt it
+    const Entity recycled = ecs.CreateEntity();
+    CHECK(EntityIndex(recycled) == EntityIndex(parent));
+    CHECK(!ecs.HasComponent<Children>(recycled));
+    CHECK(ecs.SetParent(child, root));
+    CHECK((ChildrenOf(ecs, root) == std::vector<Entity>{child}));
+}
+
+TEST_CASE(SetParentRejectsCycles)
+{
+    ECS ecs;
+    RegisterHierarchy(ecs);
+    const Entity a = ecs.CreateEntity();
+    const Entity b = ecs.CreateEntity();
+    const Entity c = ecs.CreateEntity();
+    CHECK(ecs.SetParent(b, a));
+    CHECK(ecs.SetParent(c, b));
+
+    CHECK(!ecs.SetParent(a, a));
+    CHECK(!ecs.SetParent(a, c));
+    CHECK(!ecs.SetParent(a, b));
+    CHECK(!ecs.HasComponent<Parent>(a));
+    CHECK((ChildrenOf(ecs, b) == std::vector<Entity>{c}));
+
+    // Moving a subtree elsewhere within itself is fine once it is no cycle
+    CHECK(ecs.SetParent(c, a));
+    CHECK(ChildrenOf(ecs, b).empty());
+    CHECK(ecs.SetParent(c, NULL_ENTITY));
+    CHECK(ecs.GetComponent<const Parent>(c).Handle == NULL_ENTITY);
+}
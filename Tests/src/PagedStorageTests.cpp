@@ -0,0 +1,132 @@
+#include "Test.h"
+
+#include "Hazel/ECS/ComponentArray.h"
+
+using namespace Hazel;
+
+namespace
+{
+    struct Value
+    {
+        int X;
+    };
+}
+
+TEST_CASE(PagedVectorGrowsAcrossPages)
+{
+    PagedVector<int, 4> vector;
+    for (int i = 0; i < 10; ++i)
+    {
+        vector.EmplaceBack(i);
+    }
+    CHECK(vector.Size() == 10);
+    CHECK(vector.PageCount() == 3);
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        CHECK(vector[i] == static_cast<int>(i));
+    }
+
+    // References stay valid while the vector grows, pages never move
+    const int* first = &vector[0];
+    for (int i = 10; i < 100; ++i)
+    {
+        vector.EmplaceBack(i);
+    }
+    CHECK(first == &vector[0]);
+
+    while (vector.Size() > 5)
+    {
+        vector.PopBack();
+    }
+    CHECK(vector.PageCount() == 2);
+    CHECK(vector[4] == 4);
+}
+
+TEST_CASE(SparsePagedArrayAllocatesWrittenPagesOnly)
+{
+    SparsePagedArray<unsigned, 16> array(~0u);
+    CHECK(array.Get(1000) == ~0u);
+    CHECK(array.PageCount() == 0);
+
+    array.Mutable(1000) = 7;
+    CHECK(array.Get(1000) == 7);
+    CHECK(array.Get(1001) == ~0u);
+    CHECK(array.PageAt(1000 / 16) != nullptr);
+    CHECK(array.PageAt(0) == nullptr);
+
+    array.Mutable(1000) = ~0u;
+    array.ShrinkToFit();
+    CHECK(array.PageCount() == 0);
+}
+
+TEST_CASE(ComponentArrayFindsComponentsByEntity)
+{
+    ComponentArray<Value> pool;
+    for (unsigned i = 0; i < 10000; ++i)
+    {
+        pool.InsertData(MakeEntity(i * 3, 1), Value{static_cast<int>(i)});
+    }
+    CHECK(pool.Size() == 10000);
+    for (unsigned i = 0; i < 10000; ++i)
+    {
+        const Entity entity = MakeEntity(i * 3, 1);
+        CHECK(pool.Contains(entity));
+        CHECK(std::as_const(pool).GetData(entity).X == static_cast<int>(i));
+    }
+
+    // Same slot, another generation: a stale or newer handle is not the owner
+    CHECK(!pool.Contains(MakeEntity(3, 2)));
+    CHECK(!pool.Contains(MakeEntity(1, 1)));
+    CHECK(pool.IndexOf(MakeEntity(1, 1)) == EntitySet::INVALID_INDEX);
+    CHECK(pool.TryGet(MakeEntity(1, 1)) == nullptr);
+}
+
+TEST_CASE(ComponentArrayRemovesBySwapAndPop)
+{
+    ComponentArray<Value> pool;
+    for (unsigned i = 0; i < 5; ++i)
+    {
+        pool.InsertData(MakeEntity(i, 0), Value{static_cast<int>(i)});
+    }
+
+    // The last component takes the place of the removed one
+    pool.RemoveData(MakeEntity(1, 0));
+    CHECK(pool.Size() == 4);
+    CHECK(!pool.Contains(MakeEntity(1, 0)));
+    CHECK(pool.EntityAt(1) == MakeEntity(4, 0));
+    CHECK(std::as_const(pool).At(1).X == 4);
+    for (const unsigned i : {0u, 2u, 3u, 4u})
+    {
+        CHECK(std::as_const(pool).GetData(MakeEntity(i, 0)).X == static_cast<int>(i));
+    }
+
+    pool.RemoveData(MakeEntity(4, 0));
+    pool.RemoveData(MakeEntity(0, 0));
+    pool.RemoveData(MakeEntity(2, 0));
+    pool.RemoveData(MakeEntity(3, 0));
+    CHECK(pool.Size() == 0);
+
+    // Slots are reusable once empty
+    pool.InsertData(MakeEntity(1, 1), Value{11});
+    CHECK(std::as_const(pool).GetData(MakeEntity(1, 1)).X == 11);
+}
+
+TEST_CASE(ComponentArrayKeepsDisabledEntriesBehind)
+{
+    ComponentArray<Value> pool;
+    pool.InsertData(MakeEntity(0, 0), Value{0});
+    pool.InsertData(MakeEntity(1, 0), Value{1}, false);
+    pool.InsertData(MakeEntity(2, 0), Value{2});
+    CHECK(pool.ActiveSize() == 2);
+    CHECK(pool.IndexOf(MakeEntity(1, 0)) == 2);
+
+    pool.SetEntityEnabled(MakeEntity(0, 0), false);
+    CHECK(pool.ActiveSize() == 1);
+    CHECK(pool.EntityAt(0) == MakeEntity(2, 0));
+
+    pool.RemoveData(MakeEntity(2, 0));
+    CHECK(pool.ActiveSize() == 0);
+    CHECK(pool.Size() == 2);
+    CHECK(std::as_const(pool).GetData(MakeEntity(0, 0)).X == 0);
+    CHECK(std::as_const(pool).GetData(MakeEntity(1, 0)).X == 1);
+}
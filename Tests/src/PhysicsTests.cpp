@@ -0,0 +1,76 @@
+#include "Test.h"
+
+#include <algorithm>
+
+#include "Hazel/ECS/ECSCore.h"
+#include "Hazel/ECS/Systems.h"
+
+using namespace Hazel;
+
+namespace
+{
+    // Collects the entities whose Transform changed since its previous update
+    class ChangeProbeSystem : public System
+    {
+    public:
+        explicit ChangeProbeSystem(ECS* ecs) : System(ecs)
+        {
+        }
+
+        Ref<System> Clone() const override
+        {
+            return std::static_pointer_cast<System>(std::make_shared<ChangeProbeSystem>(*this));
+        }
+
+        void OnUpdate(Timestep ts) override
+        {
+            Changed.clear();
+            m_ECS->View<const Transform>().Where(Hazel::Changed<Transform>{m_LastRunTick}).Each(
+                [this](Entity entity, const Transform&)
+                {
+                    Changed.push_back(entity);
+                });
+            std::sort(Changed.begin(), Changed.end());
+        }
+
+        std::vector<Entity> Changed;
+    };
+
+    Entity CreateBody(ECS& ecs, const glm::vec3& velocity, bool movable)
+    {
+        return ecs.CreateEntityWith(Transform{{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f}, 0.0f},
+                                    RigidBody{velocity, {0.0f, 0.0f, 0.0f}, 1.0f, movable});
+    }
+}
+
+TEST_CASE(PhysicsOnlyChangesBodiesThatMove)
+{
+    ECS ecs;
+    ecs.RegisterComponent<Transform>();
+    ecs.RegisterComponent<RigidBody>();
+    ecs.RegisterComponent<Gravity>();
+    ecs.EnableChangeTracking<Transform>();
+
+    ecs.RegisterSystem<PhysicsSystem>();
+    ecs.SetSystemSignature<PhysicsSystem>(ecs.MakeSignature<Transform, RigidBody>());
+    ecs.SetSystemAccess<PhysicsSystem>(ecs.MakeSignature<Transform, RigidBody, Gravity>(), ecs.MakeSignature<Transform, RigidBody>());
+    const Ref<ChangeProbeSystem> probe = ecs.RegisterSystem<ChangeProbeSystem>();
+    ecs.SetSystemAccess<ChangeProbeSystem>(ecs.MakeSignature<Transform>(), Signature());
+
+    const Entity fixed = CreateBody(ecs, {1.0f, 0.0f, 0.0f}, false);
+    const Entity resting = CreateBody(ecs, {0.0f, 0.0f, 0.0f}, true);
+    const Entity moving = CreateBody(ecs, {1.0f, 0.0f, 0.0f}, true);
+    const Entity falling = CreateBody(ecs, {0.0f, 0.0f, 0.0f}, true);
+    ecs.AddComponent(falling, Gravity{{0.0f, -9.8f, 0.0f}});
+
+    // Every body is new on the first update, after that only the moving ones change
+    ecs.OnUpdate(Timestep(1.0f / 60.0f));
+    CHECK(probe->Changed.size() == 4);
+    ecs.OnUpdate(Timestep(1.0f / 60.0f));
+    CHECK((probe->Changed == std::vector<Entity>{moving, falling}));
+
+    CHECK(Transform(ecs.GetComponent<const Transform>(fixed)).Position.x == 0.0f);
+    CHECK(Transform(ecs.GetComponent<const Transform>(resting)).Position.x == 0.0f);
+    CHECK(Transform(ecs.GetComponent<const Transform>(moving)).Position.x > 0.0f);
+    CHECK(Transform(ecs.GetComponent<const Transform>(falling)).Position.y < 0.0f);
+}
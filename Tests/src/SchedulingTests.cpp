@@ -0,0 +1,99 @@
+#include "Test.h"
+
+#include <atomic>
+#include <thread>
+
+#include "Hazel/Core/ThreadPool.h"
+#include "Hazel/ECS/ECSCore.h"
+
+using namespace Hazel;
+
+namespace
+{
+    struct Position
+    {
+        float X;
+    };
+
+    struct Velocity
+    {
+        float X;
+    };
+
+    std::atomic<unsigned> s_Step{0};
+
+    // Records the step it ran at and the thread it ran on
+    template <unsigned Id>
+    class RecordingSystem : public System
+    {
+    public:
+        explicit RecordingSystem(ECS* ecs) : System(ecs)
+        {
+        }
+
+        Ref<System> Clone() const override
+        {
+            return std::static_pointer_cast<System>(std::make_shared<RecordingSystem>(*this));
+        }
+
+        void OnUpdate(Timestep ts) override
+        {
+            Step = s_Step++;
+            Thread = std::this_thread::get_id();
+        }
+
+        unsigned Step = ~0u;
+        std::thread::id Thread;
+    };
+
+    using Integrate = RecordingSystem<0>;
+    using Draw = RecordingSystem<1>;
+    using Steer = RecordingSystem<2>;
+}
+
+TEST_CASE(MainThreadSystemsRunOnTheCallingThread)
+{
+    ECS ecs;
+    ecs.RegisterComponent<Position>();
+    ecs.RegisterComponent<Velocity>();
+
+    // Integrate and Draw share a stage, Steer writes what Integrate reads and comes a stage later
+    const Ref<Integrate> integrate = ecs.RegisterSystem<Integrate>();
+    ecs.SetSystemAccess<Integrate>(ecs.MakeSignature<Velocity>(), ecs.MakeSignature<Position>());
+    const Ref<Draw> draw = ecs.RegisterSystem<Draw>();
+    ecs.SetSystemAccess<Draw>(ecs.MakeSignature<Velocity>(), Signature(), true);
+    const Ref<Steer> steer = ecs.RegisterSystem<Steer>();
+    ecs.SetSystemAccess<Steer>(Signature(), ecs.MakeSignature<Velocity>());
+
+    for (unsigned frame = 0; frame < 100; ++frame)
+    {
+        s_Step = 0;
+        ecs.OnUpdate(Timestep(0.016f));
+        CHECK(draw->Thread == std::this_thread::get_id());
+        CHECK(integrate->Step < 2 && draw->Step < 2);
+        CHECK(steer->Step == 2);
+    }
+}
+
+TEST_CASE(ParallelForRunsCallerWorkAlongsideTheWorkers)
+{
+    ThreadPool pool(3);
+    for (unsigned count = 0; count < 64; ++count)
+    {
+        std::vector<std::atomic<unsigned>> runs(count);
+        std::thread::id callerThread;
+        pool.ParallelFor(count, [&runs](unsigned i)
+        {
+            ++runs[i];
+        }, [&callerThread]
+        {
+            callerThread = std::this_thread::get_id();
+        });
+
+        CHECK(callerThread == std::this_thread::get_id());
+        for (const std::atomic<unsigned>& run : runs)
+        {
+            CHECK(run == 1);
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#include "Test.h"
+
+#include <filesystem>
+
+#include "Hazel/ECS/WorldSerializer.h"
+
+namespace
+{
+    struct Point
+    {
+        float X;
+        int Y;
+    };
+
+    struct Palette
+    {
+        int Color;
+
+        bool operator==(const Palette& other) const
+        {
+            return Color == other.Color;
+        }
+    };
+
+    // Stands in for a resource handle that has to be saved as an index
+    struct Material
+    {
+        const char* Name;
+
+        bool operator==(const Material& other) const
+        {
+            return Name == other.Name;
+        }
+    };
+
+    struct MaterialRecord
+    {
+        uint32_t Index;
+    };
+
+    const char* const s_Materials[] = {"Stone", "Wood", "Glass"};
+}
+
+namespace Hazel
+{
+    template <>
+    struct ComponentTraits<Point>
+    {
+        using Columns = ColumnLayout<&Point::X, &Point::Y>;
+    };
+
+    template <>
+    struct ComponentTraits<Palette>
+    {
+        using Columns = void;
+        static constexpr bool Shared = true;
+
+        static size_t Hash(const Palette& palette)
+        {
+            return std::hash<int>()(palette.Color);
+        }
+    };
+
+    template <>
+    struct ComponentTraits<Material>
+    {
+        using Columns = void;
+        static constexpr bool Shared = true;
+
+        static size_t Hash(const Material& material)
+        {
+            return std::hash<const char*>()(material.Name);
+        }
+    };
+}
+
+using namespace Hazel;
+
+namespace
+{
+    void RegisterComponents(ECS& ecs)
+    {
+        ecs.RegisterComponent<Point>();
+        ecs.RegisterComponent<Palette>();
+        ecs.RegisterComponent<Material>();
+    }
+
+    uint32_t MaterialIndex(const Material& material)
+    {
+        uint32_t index = 0;
+        while (s_Materials[index] != material.Name)
+        {
+            ++index;
+        }
+        return index;
+    }
+}
+
+TEST_CASE(SavedWorldLoadsBackEqual)
+{
+    WorldSerializer serializer;
+    serializer.RegisterComponent<Point>("Point");
+    serializer.RegisterComponent<Palette>("Palette");
+    serializer.RegisterComponent<Material, MaterialRecord>(
+        "Material",
+        [](const Material& material) { return MaterialRecord{MaterialIndex(material)}; },
+        [](const MaterialRecord& record) { return Material{s_Materials[record.Index]}; });
+
+    ECS ecs;
+    RegisterComponents(ecs);
+    std::vector<Entity> entities;
+    for (int i = 0; i < 3000; ++i)
+    {
+        const Entity entity = ecs.CreateEntityWith(Point{i * 0.5f, -i});
+        ecs.AddComponent(entity, Palette{i % 7});
+        if (i % 2 == 0)
+        {
+            ecs.AddComponent(entity, Material{s_Materials[i % 3]});
+        }
+        entities.push_back(entity);
+    }
+
+    // Leaves a free slot in the value table of Palette
+    for (int i = 0; i < 3000; i += 7)
+    {
+        ecs.DestroyEntity(entities[i]);
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "HazelSerializerTest.hzworld").string();
+    CHECK(serializer.Save(ecs, path));
+
+    ECS loaded;
+    RegisterComponents(loaded);
+    CHECK(serializer.Load(loaded, path));
+    std::filesystem::remove(path);
+
+    unsigned count = 0;
+    loaded.View<const Point>().Each([&count](Entity, const Point&) { ++count; });
+    CHECK(count == 3000 - 429);
+    for (int i = 0; i < 3000; ++i)
+    {
+        const Entity entity = entities[i];
+        CHECK(loaded.IsAlive(entity) == (i % 7 != 0));
+        if (!loaded.IsAlive(entity))
+        {
+            continue;
+        }
+
+        const Point point = loaded.GetComponent<const Point>(entity);
+        CHECK(point.X == i * 0.5f && point.Y == -i);
+        CHECK(loaded.GetComponent<const Palette>(entity).Color == i % 7);
+        CHECK(loaded.HasComponent<Material>(entity) == (i % 2 == 0));
+        if (i % 2 == 0)
+        {
+            CHECK(loaded.GetComponent<const Material>(entity).Name == s_Materials[i % 3]);
+        }
+    }
+
+    // Equal values are stored once, and new components still find them
+    const Entity added = loaded.CreateEntityWith(Palette{3});
+    CHECK(&loaded.GetComponent<const Palette>(added) == &loaded.GetComponent<const Palette>(entities[3]));
+    CHECK(&loaded.GetComponent<const Palette>(entities[3]) == &loaded.GetComponent<const Palette>(entities[10]));
+    CHECK(&loaded.GetComponent<const Material>(entities[2]) == &loaded.GetComponent<const Material>(entities[8]));
+}
@@ -0,0 +1,172 @@
+#include "Test.h"
+
+#include "Hazel/ECS/ECSCore.h"
+
+using namespace Hazel;
+
+namespace
+{
+    struct Value
+    {
+        int X;
+    };
+
+    struct Tag
+    {
+    };
+
+    class ResetCountingSystem : public System
+    {
+    public:
+        explicit ResetCountingSystem(ECS* ecs) : System(ecs)
+        {
+        }
+
+        Ref<System> Clone() const override
+        {
+            return std::static_pointer_cast<System>(std::make_shared<ResetCountingSystem>(*this));
+        }
+
+        void OnUpdate(Timestep ts) override
+        {
+            ++Updates;
+        }
+
+        void OnWorldReset() override
+        {
+            ++Resets;
+        }
+
+        unsigned Updates = 0;
+        unsigned Resets = 0;
+    };
+}
+
+TEST_CASE(CopiedVectorsSharePagesUntilWritten)
+{
+    PagedVector<int, 4> vector;
+    for (int i = 0; i < 12; ++i)
+    {
+        vector.EmplaceBack(i);
+    }
+
+    const PagedVector<int, 4> copy = vector;
+    for (unsigned page = 0; page < 3; ++page)
+    {
+        CHECK(copy.PageAt(page) == vector.PageAt(page));
+    }
+
+    // Only the written page is cloned, the copy keeps the old value
+    vector.Mutable(5) = 50;
+    CHECK(copy.PageAt(0) == vector.PageAt(0));
+    CHECK(copy.PageAt(1) != vector.PageAt(1));
+    CHECK(copy.PageAt(2) == vector.PageAt(2));
+    CHECK(vector[5] == 50);
+    CHECK(copy[5] == 5);
+}
+
+TEST_CASE(VectorDiffRecordsOnlyWrittenPages)
+{
+    PagedVector<int, 4> vector;
+    for (int i = 0; i < 12; ++i)
+    {
+        vector.EmplaceBack(i);
+    }
+    const PagedVector<int, 4> older = vector;
+
+    vector.Mutable(1) = 10;
+    vector.Mutable(9) = 90;
+    vector.PopBack();
+    vector.EmplaceBack(110);
+    vector.EmplaceBack(120);
+
+    const ElementDelta<int> delta = vector.Diff(older);
+    CHECK(delta.Indices.size() == 3);
+
+    vector.Revert(delta);
+    CHECK(vector.Size() == older.Size());
+    for (unsigned i = 0; i < older.Size(); ++i)
+    {
+        CHECK(vector[i] == older[i]);
+    }
+}
+
+TEST_CASE(WorldRevertUndoesChangesSinceSnapshot)
+{
+    ECS ecs;
+    ecs.RegisterComponent<Value>();
+    ecs.RegisterComponent<Tag>();
+
+    std::vector<Entity> entities;
+    for (int i = 0; i < 100; ++i)
+    {
+        entities.push_back(ecs.CreateEntityWith(Value{i}));
+    }
+    const ECS snapshot = ecs.CreateSnapshot();
+
+    // Write, add, remove, create and destroy after the snapshot
+    ecs.GetComponent<Value>(entities[3]).X = -3;
+    ecs.AddComponent(entities[4], Tag{});
+    ecs.RemoveComponent<Value>(entities[5]);
+    ecs.DestroyEntity(entities[6]);
+    const Entity created = ecs.CreateEntityWith(Value{1000});
+    CHECK(ecs.IsAlive(created));
+
+    CHECK(ecs.HasSameLayout(snapshot));
+    ecs.Revert(ecs.Diff(snapshot));
+
+    CHECK(ecs.GetComponent<Value>(entities[3]).X == 3);
+    CHECK(!ecs.HasComponent<Tag>(entities[4]));
+    CHECK(ecs.HasComponent<Value>(entities[5]));
+    CHECK(ecs.GetComponent<Value>(entities[5]).X == 5);
+    CHECK(ecs.IsAlive(entities[6]));
+    CHECK(ecs.GetComponent<Value>(entities[6]).X == 6);
+    CHECK(!ecs.IsAlive(created));
+
+    unsigned count = 0;
+    ecs.View<const Value>().Each([&count](Entity entity, const Value& value)
+    {
+        CHECK(value.X == static_cast<int>(EntityIndex(entity)));
+        ++count;
+    });
+    CHECK(count == 100);
+}
+
+TEST_CASE(SnapshotsAreUnaffectedByLaterWrites)
+{
+    ECS ecs;
+    ecs.RegisterComponent<Value>();
+    const Entity entity = ecs.CreateEntityWith(Value{1});
+
+    ECS snapshot = ecs.CreateSnapshot();
+    ecs.GetComponent<Value>(entity).X = 2;
+    ecs.DestroyEntity(entity);
+
+    CHECK(snapshot.IsAlive(entity));
+    CHECK(snapshot.GetComponent<Value>(entity).X == 1);
+}
+
+TEST_CASE(SystemsAreResetAfterRevertAndAssignment)
+{
+    ECS ecs;
+    ecs.RegisterComponent<Value>();
+    ecs.RegisterSystem<ResetCountingSystem>();
+    ecs.SetSystemSignature<ResetCountingSystem>(ecs.MakeSignature<Value>());
+
+    // Once before the first update, then only when the world was replaced
+    ecs.OnUpdate(Timestep(0.0f));
+    ecs.OnUpdate(Timestep(0.0f));
+    CHECK(ecs.GetSystem<ResetCountingSystem>()->Resets == 1);
+
+    const ECS snapshot = ecs.CreateSnapshot();
+    ecs.CreateEntityWith(Value{1});
+    ecs.Revert(ecs.Diff(snapshot));
+    ecs.OnUpdate(Timestep(0.0f));
+    CHECK(ecs.GetSystem<ResetCountingSystem>()->Resets == 2);
+
+    // The assigned systems are copies of the snapshot's, which had seen one reset and two updates
+    ecs = snapshot;
+    ecs.OnUpdate(Timestep(0.0f));
+    CHECK(ecs.GetSystem<ResetCountingSystem>()->Resets == 2);
+    CHECK(ecs.GetSystem<ResetCountingSystem>()->Updates == 3);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+// Minimal test harness. TEST_CASE defines a function that TestMain.cpp runs, CHECK reports a
+// failed expression and lets the case carry on.
+namespace Hazel::Test
+{
+    using TestFunc = void (*)();
+
+    struct TestCase
+    {
+        const char* Name;
+        TestFunc Func;
+    };
+
+    // Every case in the executable, in order of static initialization
+    std::vector<TestCase>& Registry();
+
+    // Counts a failure of the running case
+    void Fail(const char* expression, const char* file, int line);
+
+    struct Registrar
+    {
+        Registrar(const char* name, TestFunc func)
+        {
+            Registry().push_back({name, func});
+        }
+    };
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static ::Hazel::Test::Registrar s_##name##Registrar(#name, &name); \
+    static void name()
+
+#define CHECK(x) { if (!(x)) { ::Hazel::Test::Fail(#x, __FILE__, __LINE__); } }
@@ -0,0 +1,50 @@
+#include "Test.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "Hazel/Core/Log.h"
+
+namespace Hazel::Test
+{
+    static unsigned s_Failures = 0;
+
+    std::vector<TestCase>& Registry()
+    {
+        static std::vector<TestCase> s_Registry;
+        return s_Registry;
+    }
+
+    void Fail(const char* expression, const char* file, int line)
+    {
+        std::printf("    %s(%d): CHECK(%s) failed\n", file, line, expression);
+        ++s_Failures;
+    }
+}
+
+// Runs every case, or the ones whose name contains the first argument. Returns the number of
+// failed cases.
+int main(int argc, char** argv)
+{
+    Hazel::Log::Init();
+
+    const char* filter = argc > 1 ? argv[1] : "";
+    int failedCases = 0;
+    unsigned ranCases = 0;
+    for (const Hazel::Test::TestCase& testCase : Hazel::Test::Registry())
+    {
+        if (!std::strstr(testCase.Name, filter))
+        {
+            continue;
+        }
+
+        std::printf("%s\n", testCase.Name);
+        const unsigned failures = Hazel::Test::s_Failures;
+        testCase.Func();
+        failedCases += Hazel::Test::s_Failures != failures ? 1 : 0;
+        ++ranCases;
+    }
+
+    std::printf("%u cases, %d failed\n", ranCases, failedCases);
+    return failedCases;
+}
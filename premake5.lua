@@ -138,6 +138,116 @@ project "Sandbox"
         systemversion "latest"
 
 
+    filter "configurations:Debug"
+        defines "HZ_DEBUG"
+        runtime "Debug"
+        symbols "on"
+
+    filter "configurations:Release"
+        defines "HZ_RELEASE"
+        runtime "Release"
+        optimize "on"
+        buildoptions {
+            "/O2", "/Ob2", "/Ot", "/Oy", "/GT", "/LTCG", "/GL"
+        }
+
+    filter "configurations:Dist"
+        defines "HZ_DIST"
+        runtime "Release"
+        optimize "on"
+        buildoptions {
+            "/O2", "/Ob2", "/Ot", "/Oy", "/GT", "/LTCG", "/GL"
+        }
+
+project "Tests"
+    location "Tests"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+    staticruntime "on"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+    files
+    {
+        "%{prj.name}/src/**.h",
+        "%{prj.name}/src/**.cpp"
+    }
+
+    includedirs
+    {
+        "Hazel/vendor/spdlog/include",
+        "Hazel/src",
+        "Hazel/vendor",
+        "%{IncludeDir.glm}",
+        "%{IncludeDir.HazelAudio}"
+    }
+
+    links
+    {
+        "Hazel"
+    }
+
+    filter "system:windows"
+        systemversion "latest"
+
+
+    filter "configurations:Debug"
+        defines "HZ_DEBUG"
+        runtime "Debug"
+        symbols "on"
+
+    filter "configurations:Release"
+        defines "HZ_RELEASE"
+        runtime "Release"
+        optimize "on"
+        buildoptions {
+            "/O2", "/Ob2", "/Ot", "/Oy", "/GT", "/LTCG", "/GL"
+        }
+
+    filter "configurations:Dist"
+        defines "HZ_DIST"
+        runtime "Release"
+        optimize "on"
+        buildoptions {
+            "/O2", "/Ob2", "/Ot", "/Oy", "/GT", "/LTCG", "/GL"
+        }
+
+project "Benchmarks"
+    location "Benchmarks"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+    staticruntime "on"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+    files
+    {
+        "%{prj.name}/src/**.h",
+        "%{prj.name}/src/**.cpp"
+    }
+
+    includedirs
+    {
+        "Hazel/vendor/spdlog/include",
+        "Hazel/src",
+        "Hazel/vendor",
+        "%{IncludeDir.glm}",
+        "%{IncludeDir.HazelAudio}"
+    }
+
+    links
+    {
+        "Hazel"
+    }
+
+    filter "system:windows"
+        systemversion "latest"
+
+
     filter "configurations:Debug"
         defines "HZ_DEBUG"
         runtime "Debug"